@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "OSTL/aligned_allocator.h"
+#include "OSTL/string.h"
+#include "OSTL/vector.h"
+
+namespace
+{
+	bool IsAligned(const void* p, const size_t align) { return reinterpret_cast<uintptr_t>(p) % align == 0; }
+}
+
+TEST(AlignedAllocator, Vector)
+{
+	ostl::vector<float, ostl::aligned_allocator<float, 32>> v;
+	for (auto i = 0; i < 1000; ++i)
+	{
+		v.push_back(static_cast<float>(i));
+		ASSERT_TRUE(IsAligned(v.data(), 32));
+		ASSERT_EQ(v.capacity() * sizeof(float) % 32, 0);
+	}
+	ASSERT_EQ(v[999], 999.0f);
+
+	ostl::vector<char, ostl::aligned_allocator<char>> line(1);
+	ASSERT_TRUE(IsAligned(line.data(), 64));
+	ASSERT_EQ(line.capacity(), 64);
+
+	struct alignas(128) Wide { char c; };
+	static_assert(ostl::aligned_allocator<Wide, 64>::alignment == 128);
+	ostl::vector<Wide, ostl::aligned_allocator<Wide, 64>> wide(3);
+	ASSERT_TRUE(IsAligned(wide.data(), 128));
+}
+
+TEST(AlignedAllocator, Bool)
+{
+	ostl::vector<bool, ostl::aligned_allocator<bool, 64>> bits(1000, true);
+	ASSERT_TRUE(IsAligned(bits.words(), 64));
+	bits.resize(100000, false);
+	ASSERT_TRUE(IsAligned(bits.words(), 64));
+	ASSERT_EQ(bits.count(), 1000);
+}
+
+TEST(AlignedAllocator, String)
+{
+	ostl::basic_string<char, std::char_traits<char>, ostl::aligned_allocator<char>> str;
+	(void)str;
+}
@@ -0,0 +1,192 @@
+#include "gtest/gtest.h"
+#include "OSTL/concurrent_vector.h"
+#include "test_util.h"
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct Entry
+	{
+		int thread;
+		int seq;
+		int check;
+	};
+
+	struct ThrowOnNegative
+	{
+		explicit ThrowOnNegative(const int v) : value{v}
+		{
+			if (v < 0) throw std::runtime_error{""};
+		}
+
+		int value;
+	};
+}
+
+TEST(ConcurrentVector, Basic)
+{
+	ostl::concurrent_vector<int> v;
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ(v.capacity(), 0);
+
+	for (auto i = 0; i < 1000; ++i) ASSERT_EQ(*v.push_back(i), i);
+	ASSERT_EQ(v.size(), 1000);
+	ASSERT_GE(v.capacity(), 1000);
+	ASSERT_EQ(v.front(), 0);
+	ASSERT_EQ(v.back(), 999);
+	ASSERT_EQ(std::accumulate(v.begin(), v.end(), 0), 999 * 1000 / 2);
+	ASSERT_EQ(*v.rbegin(), 999);
+	ASSERT_EQ(v.end() - v.begin(), 1000);
+	ASSERT_THROW((void)v.at(1000), std::out_of_range);
+
+	// Elements never move
+	const int* first = &v[0];
+	v.reserve(100000);
+	ASSERT_GE(v.capacity(), 100000);
+	ASSERT_EQ(first, &v[0]);
+
+	auto it = v.grow_by(3, 7);
+	ASSERT_EQ(it - v.begin(), 1000);
+	ASSERT_EQ(v.size(), 1003);
+	ASSERT_EQ(v[1002], 7);
+
+	it = v.grow_by({1, 2});
+	ASSERT_EQ(*it, 1);
+	v.grow_by(2);
+	ASSERT_EQ(v.back(), 0);
+
+	for (auto& x : v) x = -x;
+	ASSERT_EQ(v[5], -5);
+
+	auto copy = v;
+	ASSERT_EQ(copy, v);
+	copy.clear();
+	ASSERT_TRUE(copy.empty());
+	copy.push_back(42);
+	ASSERT_EQ(copy.size(), 1);
+	ASSERT_EQ(copy[0], 42);
+
+	auto moved = std::move(v);
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ(moved.size(), 1007);
+}
+
+TEST(ConcurrentVector, Strings)
+{
+	ostl::concurrent_vector<std::string> v{"a", "b"};
+	for (auto i = 0; i < 100; ++i) v.emplace_back(100, 'x');
+	ASSERT_EQ(v.size(), 102);
+	ASSERT_EQ(v[0], "a");
+	ASSERT_EQ(v[101].size(), 100);
+}
+
+TEST(ConcurrentVector, ThrowingConstructor)
+{
+	ostl::concurrent_vector<ThrowOnNegative> v;
+	v.emplace_back(1);
+	ASSERT_THROW(v.emplace_back(-1), std::runtime_error);
+	v.emplace_back(3);
+
+	// The failed slot is skipped over, not left blocking later elements
+	ASSERT_EQ(v.size(), 3);
+	ASSERT_EQ(v[0].value, 1);
+	ASSERT_EQ(v[2].value, 3);
+}
+
+TEST(ConcurrentVector, ThrowingRange)
+{
+	ostl::concurrent_vector<ThrowOnNegative> v;
+	v.emplace_back(1);
+	const int values[]{2, -1, 4};
+	ASSERT_THROW(v.grow_by(std::begin(values), std::end(values)), std::runtime_error);
+
+	// The slot after the one that threw was reserved too and must not block later appends
+	v.emplace_back(5);
+	ASSERT_EQ(v.size(), 5);
+	ASSERT_EQ(v[1].value, 2);
+	ASSERT_EQ(v[4].value, 5);
+}
+
+TEST(ConcurrentVector, AllocatorPropagation)
+{
+	using pmr_vector = ostl::concurrent_vector<int, std::pmr::polymorphic_allocator<int>>;
+	test::CountingResource r1, r2;
+	{
+		pmr_vector a{&r1}, b{&r2};
+		for (auto i = 0; i < 1000; ++i) a.push_back(i);
+		b.push_back(-1);
+
+		// polymorphic_allocator does not propagate, so b keeps its resource and takes the elements one by one
+		b = a;
+		ASSERT_EQ(b, a);
+		ASSERT_EQ(b.get_allocator().resource(), &r2);
+
+		pmr_vector c{&r2};
+		c = std::move(a);
+		ASSERT_EQ(c, b);
+		ASSERT_EQ(c.get_allocator().resource(), &r2);
+		c.push_back(1000);
+
+		// Equal allocators hand the segments over
+		const auto first = &c[0];
+		b = std::move(c);
+		ASSERT_EQ(&b[0], first);
+		ASSERT_EQ(b.size(), 1001);
+	}
+	ASSERT_EQ(r1.outstanding(), 0);
+	ASSERT_EQ(r2.outstanding(), 0);
+}
+
+TEST(ConcurrentVector, Concurrent)
+{
+	constexpr int threads = 8, per_thread = 50000;
+	ostl::concurrent_vector<Entry> v;
+	std::atomic<bool> done = false;
+
+	// Everything below size() must be fully constructed while writers are still appending
+	std::thread reader{[&]
+	{
+		while (!done.load())
+		{
+			const auto n = v.size();
+			for (size_t i = n > 1000 ? n - 1000 : 0; i < n; ++i)
+				ASSERT_EQ(v[i].check, v[i].thread ^ v[i].seq);
+		}
+	}};
+
+	std::vector<std::thread> writers;
+	for (auto t = 0; t < threads; ++t)
+	{
+		writers.emplace_back([&v, t]
+		{
+			for (auto i = 0; i < per_thread; i += 2)
+			{
+				if (i % 10 == 0)
+				{
+					const Entry e[2]{{t, i, t ^ i}, {t, i + 1, t ^ (i + 1)}};
+					v.grow_by(std::begin(e), std::end(e));
+				}
+				else
+				{
+					v.push_back({t, i, t ^ i});
+					v.push_back({t, i + 1, t ^ (i + 1)});
+				}
+			}
+		});
+	}
+	for (auto& w : writers) w.join();
+	done = true;
+	reader.join();
+
+	ASSERT_EQ(v.size(), threads * per_thread);
+	std::vector<int> last(threads, -1);
+	for (const auto& e : v)
+	{
+		ASSERT_EQ(e.check, e.thread ^ e.seq);
+		ASSERT_EQ(e.seq, last[e.thread] + 1);
+		last[e.thread] = e.seq;
+	}
+}
@@ -0,0 +1,242 @@
+#include "gtest/gtest.h"
+#include "OSTL/deque.h"
+#include "test_util.h"
+#include <deque>
+#include <random>
+#include <string>
+
+namespace
+{
+	template <class D, class S>
+	void ExpectSame(const D& d, const S& s)
+	{
+		ASSERT_EQ(d.size(), s.size());
+		ASSERT_TRUE(std::equal(d.begin(), d.end(), s.begin()));
+		for (size_t i = 0; i < s.size(); ++i) ASSERT_EQ(d[i], s[i]);
+	}
+
+	// Random operations mirrored on std::deque
+	template <class T, size_t B, class Make>
+	void Fuzz(Make make)
+	{
+		ostl::deque<T, std::allocator<T>, B> d;
+		std::deque<T> s;
+		const auto position = [&](std::mt19937& rng) { return s.empty() ? 0 : rng() % (s.size() + 1); };
+
+		const auto push_back = [&](std::mt19937&, const int step)
+		{
+			d.push_back(make(step));
+			s.push_back(make(step));
+		};
+		const auto push_front = [&](std::mt19937&, const int step)
+		{
+			d.push_front(make(step));
+			s.push_front(make(step));
+		};
+		const auto pop_back = [&](std::mt19937&, int)
+		{
+			if (s.empty()) return;
+			d.pop_back();
+			s.pop_back();
+		};
+		const auto pop_front = [&](std::mt19937&, int)
+		{
+			if (s.empty()) return;
+			d.pop_front();
+			s.pop_front();
+		};
+		const auto insert = [&](std::mt19937& rng, const int step)
+		{
+			const auto i = position(rng);
+			const auto n = rng() % 20;
+			d.insert(d.begin() + i, n, make(step));
+			// libstdc++ self-move-assigns elements on an empty insert, which clears strings
+			if (n) s.insert(s.begin() + i, n, make(step));
+		};
+		const auto erase = [&](std::mt19937& rng, int)
+		{
+			if (s.empty()) return;
+			const auto i = rng() % s.size();
+			const auto n = std::min<size_t>(rng() % 20, s.size() - i);
+			const auto it = d.erase(d.begin() + i, d.begin() + i + n);
+			ASSERT_EQ(it - d.begin(), static_cast<ptrdiff_t>(i));
+			s.erase(s.begin() + i, s.begin() + i + n);
+		};
+		const auto emplace = [&](std::mt19937& rng, const int step)
+		{
+			const auto i = position(rng);
+			ASSERT_EQ(*d.emplace(d.begin() + i, make(step)), make(step));
+			s.emplace(s.begin() + i, make(step));
+		};
+		// The inserted value is an element of the deque itself
+		const auto insert_own = [&](std::mt19937& rng, int)
+		{
+			if (s.empty()) return;
+			const auto i = rng() % s.size();
+			d.insert(d.begin() + i, d[s.size() - 1 - i]);
+			s.insert(s.begin() + i, T{s[s.size() - 1 - i]});
+		};
+
+		test::Fuzz(20000, 1000, [&] { ExpectSame(d, s); }, push_back, push_back, push_front, push_front, pop_back,
+		           pop_front, insert, erase, emplace, insert_own);
+
+		d.shrink_to_fit();
+		ExpectSame(d, s);
+		d.clear();
+		ASSERT_TRUE(d.empty());
+	}
+}
+
+TEST(Deque, FuzzTrivial)
+{
+	Fuzz<int, 16>([](int i) { return i; });
+	Fuzz<int, 1000>([](int i) { return i; });
+}
+
+TEST(Deque, FuzzString)
+{
+	Fuzz<std::string, 16>([](int i) { return std::to_string(i) + std::string(i % 40, 'x'); });
+}
+
+TEST(Deque, AllocatorPropagation)
+{
+	using pmr_deque = ostl::deque<std::string, std::pmr::polymorphic_allocator<std::string>, 16>;
+	test::CountingResource r1, r2;
+	{
+		pmr_deque a{&r1}, b{&r2};
+		for (auto i = 0; i < 1000; ++i) a.push_back(std::to_string(i));
+		b.push_back("x");
+
+		// polymorphic_allocator does not propagate, so b keeps its resource and takes the elements one by one
+		b = a;
+		ASSERT_EQ(b, a);
+		ASSERT_EQ(b.get_allocator().resource(), &r2);
+
+		pmr_deque c{&r2};
+		c = std::move(a);
+		ASSERT_EQ(c, b);
+		ASSERT_EQ(c.get_allocator().resource(), &r2);
+
+		// Equal allocators hand the blocks over
+		const auto first = &c[0];
+		b = std::move(c);
+		ASSERT_EQ(&b[0], first);
+		ASSERT_EQ(b.size(), 1000);
+	}
+	ASSERT_EQ(r1.outstanding(), 0);
+	ASSERT_EQ(r2.outstanding(), 0);
+}
+
+TEST(Deque, StableReferences)
+{
+	ostl::deque<int> d;
+	d.push_back(1);
+	int* const p = &d.front();
+	for (auto i = 0; i < 100000; ++i)
+	{
+		d.push_back(i);
+		d.push_front(-i);
+	}
+	ASSERT_EQ(p, &d[100000]);
+	ASSERT_EQ(*p, 1);
+
+	for (auto i = 0; i < 50000; ++i)
+	{
+		d.pop_back();
+		d.pop_front();
+	}
+	ASSERT_EQ(p, &d[50000]);
+}
+
+TEST(Deque, Fifo)
+{
+	ostl::deque<int, std::allocator<int>, 8> d;
+	for (auto i = 0; i < 100; ++i) d.push_back(i);
+	for (auto i = 100; i < 1000000; ++i)
+	{
+		d.push_back(i);
+		ASSERT_EQ(d.front(), i - 100);
+		d.pop_front();
+	}
+	ASSERT_EQ(d.size(), 100);
+	ASSERT_EQ(d.back(), 999999);
+}
+
+TEST(Deque, Interface)
+{
+	ostl::deque<int> d{1, 2, 3};
+	ASSERT_EQ(d.at(2), 3);
+	ASSERT_THROW((void)d.at(3), std::out_of_range);
+	ASSERT_EQ(*d.rbegin(), 3);
+	ASSERT_EQ(d.end() - d.begin(), 3);
+
+	auto it = d.begin();
+	it += 2;
+	ASSERT_EQ(*it, 3);
+	it -= 2;
+	ASSERT_EQ(it, d.begin());
+	ASSERT_LT(d.begin(), d.end());
+
+	ostl::deque<int> e(d);
+	ASSERT_EQ(d, e);
+	e.push_front(0);
+	ASSERT_NE(d, e);
+	ASSERT_LT(e, d);
+
+	ostl::deque<int> f(std::move(e));
+	ASSERT_TRUE(e.empty());
+	ASSERT_EQ(f.size(), 4);
+	e = f;
+	ASSERT_EQ(e, f);
+	f = std::move(e);
+	ASSERT_EQ(f.front(), 0);
+
+	f.resize(10);
+	ASSERT_EQ(f.back(), 0);
+	f.resize(12, 7);
+	ASSERT_EQ(f.back(), 7);
+	f.resize(2);
+	ASSERT_EQ(f.size(), 2);
+
+	f.assign(5, 9);
+	ASSERT_EQ(f, (ostl::deque<int>{9, 9, 9, 9, 9}));
+	ostl::erase(f, 9);
+	ASSERT_TRUE(f.empty());
+	f = {1, 2, 3, 4};
+	ostl::erase_if(f, [](int x) { return x % 2; });
+	ASSERT_EQ(f, (ostl::deque<int>{2, 4}));
+	f.clear();
+
+	const int src[]{4, 5, 6};
+	f.append_range(src);
+	f.prepend_range(src);
+	ASSERT_EQ(f, (ostl::deque<int>{4, 5, 6, 4, 5, 6}));
+
+	ostl::deque g(std::begin(src), std::end(src));
+	ASSERT_EQ(g.size(), 3);
+	swap(f, g);
+	ASSERT_EQ(f.size(), 3);
+}
+
+namespace
+{
+	struct ThrowOnCopy
+	{
+		explicit ThrowOnCopy(const int v) : value{v} {}
+		ThrowOnCopy(const ThrowOnCopy& x) : value{x.value} { if (value < 0) throw std::runtime_error{""}; }
+		ThrowOnCopy(ThrowOnCopy&&) noexcept = default;
+		int value;
+	};
+}
+
+TEST(Deque, InsertThrows)
+{
+	ostl::deque<ThrowOnCopy, std::allocator<ThrowOnCopy>, 4> d;
+	for (auto i = 0; i < 20; ++i) d.emplace_back(i);
+
+	const ThrowOnCopy src[]{ThrowOnCopy{100}, ThrowOnCopy{-1}};
+	ASSERT_THROW(d.insert(d.begin() + 3, std::begin(src), std::end(src)), std::runtime_error);
+	ASSERT_THROW(d.insert(d.begin() + 15, std::begin(src), std::end(src)), std::runtime_error);
+	ASSERT_EQ(d.size(), 20);
+	for (auto i = 0; i < 20; ++i) ASSERT_EQ(d[i].value, i);
+}
@@ -0,0 +1,185 @@
+#include "gtest/gtest.h"
+#include "OSTL/flat_hash_map.h"
+#include "OSTL/flat_hash_set.h"
+#include "test_util.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+TEST(FlatHashMap, Fuzz)
+{
+	ostl::flat_hash_map<int, int> m;
+	std::unordered_map<int, int> ref;
+	const auto key = [](std::mt19937& rng) { return static_cast<int>(rng() % 4096); };
+
+	const auto insert = [&](std::mt19937& rng, const int step)
+	{
+		const int k = key(rng);
+		ASSERT_EQ(m.insert({k, step}).second, ref.insert({k, step}).second);
+	};
+	const auto erase = [&](std::mt19937& rng, int)
+	{
+		const int k = key(rng);
+		ASSERT_EQ(m.erase(k), ref.erase(k));
+	};
+	const auto find = [&](std::mt19937& rng, int)
+	{
+		const int k = key(rng);
+		const auto it = m.find(k);
+		const auto r = ref.find(k);
+		ASSERT_EQ(it == m.end(), r == ref.end());
+		if (r != ref.end())
+		{
+			ASSERT_EQ(it->second, r->second);
+		}
+	};
+	const auto check = [&]
+	{
+		ASSERT_EQ(m.size(), ref.size());
+		size_t n = 0;
+		for (const auto& [k, v] : m)
+		{
+			ASSERT_EQ(ref.at(k), v);
+			++n;
+		}
+		ASSERT_EQ(n, ref.size());
+	};
+
+	test::Fuzz(200000, 10000, check, insert, insert, erase, find);
+	ASSERT_LE(m.load_factor(), m.max_load_factor());
+}
+
+TEST(FlatHashMap, Heterogeneous)
+{
+	ostl::flat_hash_map<std::string, int> m{{"one", 1}, {"two", 2}};
+	m["three"] = 3;
+	m[std::string(40, 'x')] = 40;
+
+	const std::string_view key = "two";
+	ASSERT_EQ(m.find(key)->second, 2);
+	ASSERT_TRUE(m.contains("one"));
+	ASSERT_FALSE(m.contains(std::string_view{"four"}));
+	ASSERT_EQ(m.at(std::string_view{"three"}), 3);
+	ASSERT_THROW((void)m.at("four"), std::out_of_range);
+	ASSERT_EQ(m.erase(std::string_view{"one"}), 1);
+	ASSERT_EQ(m.size(), 3);
+
+	ASSERT_TRUE(m.try_emplace(std::string_view{"four"}, 4).second);
+	ASSERT_FALSE(m.try_emplace("four", 5).second);
+	ASSERT_EQ(m.at("four"), 4);
+	ASSERT_FALSE(m.insert_or_assign("four", 6).second);
+	ASSERT_EQ(m["four"], 6);
+}
+
+TEST(FlatHashMap, EraseAndRehash)
+{
+	ostl::flat_hash_map<int, std::unique_ptr<int>> m;
+	for (auto i = 0; i < 1000; ++i) m.try_emplace(i, std::make_unique<int>(i));
+	const auto cap = m.capacity();
+
+	// Churn must not pile up tombstones until the table grows
+	for (auto round = 0; round < 50; ++round)
+	{
+		for (auto i = 0; i < 1000; i += 2) ASSERT_EQ(m.erase(i), 1);
+		for (auto i = 0; i < 1000; i += 2) m.try_emplace(i, std::make_unique<int>(i));
+	}
+	ASSERT_EQ(m.capacity(), cap);
+	for (auto i = 0; i < 1000; ++i) ASSERT_EQ(*m.at(i), i);
+
+	ASSERT_EQ(ostl::erase_if(m, [](const auto& kv) { return kv.first % 3 == 0; }), 334);
+	ASSERT_EQ(m.size(), 666);
+	ASSERT_FALSE(m.contains(999));
+
+	m.rehash(0);
+	ASSERT_LT(m.capacity(), cap);
+	for (auto i = 1; i < 1000; i += 3) ASSERT_EQ(*m.at(i), i);
+
+	m.clear();
+	ASSERT_TRUE(m.empty());
+	ASSERT_EQ(m.begin(), m.end());
+	m.rehash(0);
+	ASSERT_EQ(m.capacity(), 0);
+	m.reserve(100);
+	const auto reserved = m.capacity();
+	for (auto i = 0; i < 100; ++i) m.try_emplace(i);
+	ASSERT_EQ(m.capacity(), reserved);
+}
+
+TEST(FlatHashMap, CopyMove)
+{
+	ostl::flat_hash_map<std::string, std::string> a;
+	for (auto i = 0; i < 100; ++i) a.insert_or_assign(std::to_string(i), std::string(i, 'a'));
+
+	auto b = a;
+	ASSERT_EQ(a, b);
+	b["0"] = "changed";
+	ASSERT_NE(a, b);
+
+	auto c = std::move(b);
+	ASSERT_TRUE(b.empty());
+	ASSERT_EQ(c.size(), 100);
+	ASSERT_EQ(c["0"], "changed");
+
+	b = c;
+	swap(a, b);
+	ASSERT_EQ(a, c);
+	ASSERT_EQ(b.at("99"), std::string(99, 'a'));
+
+	const auto& cref = a;
+	ASSERT_EQ(cref.at("5"), "aaaaa");
+	ASSERT_EQ(cref.count("5"), 1);
+	ASSERT_EQ(std::distance(cref.begin(), cref.end()), 100);
+}
+
+TEST(FlatHashMap, AllocatorPropagation)
+{
+	using pmr_map = ostl::flat_hash_map<int, std::string, ostl::hash<int>, ostl::equal_to<int>,
+	                                    std::pmr::polymorphic_allocator<std::pair<const int, std::string>>>;
+	test::CountingResource r1, r2;
+	{
+		pmr_map a{&r1}, b{&r2};
+		for (auto i = 0; i < 1000; ++i) a.try_emplace(i, std::to_string(i));
+		b.try_emplace(-1, "x");
+
+		// polymorphic_allocator does not propagate, so b keeps its resource and takes the elements one by one
+		b = a;
+		ASSERT_EQ(b, a);
+		ASSERT_EQ(b.get_allocator().resource(), &r2);
+
+		pmr_map c{&r2};
+		c = std::move(a);
+		ASSERT_EQ(c, b);
+		ASSERT_EQ(c.get_allocator().resource(), &r2);
+
+		// Equal allocators hand the slots over
+		const auto slot = &c.at(7);
+		b = std::move(c);
+		ASSERT_EQ(&b.at(7), slot);
+		ASSERT_EQ(b.size(), 1000);
+	}
+	ASSERT_EQ(r1.outstanding(), 0);
+	ASSERT_EQ(r2.outstanding(), 0);
+}
+
+TEST(FlatHashSet, Basic)
+{
+	ostl::flat_hash_set<std::string> s{"a", "b", "c"};
+	ASSERT_FALSE(s.insert("a").second);
+	ASSERT_TRUE(s.emplace(3, 'd').second);
+	ASSERT_TRUE(s.contains(std::string_view{"ddd"}));
+	ASSERT_EQ(s.erase("b"), 1);
+	ASSERT_EQ(s.size(), 3);
+
+	ostl::flat_hash_set<int> ints;
+	for (auto i = 0; i < 10000; ++i) ints.insert(i * 7);
+	for (auto i = 0; i < 10000; ++i) ASSERT_TRUE(ints.contains(i * 7));
+	ASSERT_FALSE(ints.contains(1));
+
+	auto copy = ints;
+	ASSERT_EQ(copy, ints);
+	ASSERT_EQ(ostl::erase_if(copy, [](int x) { return x % 2; }), 5000);
+	ASSERT_NE(copy, ints);
+}
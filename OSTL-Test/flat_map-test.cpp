@@ -0,0 +1,194 @@
+#include "gtest/gtest.h"
+#include "OSTL/flat_map.h"
+#include "OSTL/flat_set.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	template <class Search>
+	void FuzzMap()
+	{
+		ostl::flat_map<int, int, std::less<int>, Search> m;
+		std::map<int, int> ref;
+		const auto key = [](std::mt19937& rng) { return static_cast<int>(rng() % 1024); };
+
+		const auto try_emplace = [&](std::mt19937& rng, const int step)
+		{
+			const int k = key(rng);
+			ASSERT_EQ(m.try_emplace(k, step).second, ref.try_emplace(k, step).second);
+		};
+		const auto erase = [&](std::mt19937& rng, int)
+		{
+			const int k = key(rng);
+			ASSERT_EQ(m.erase(k), ref.erase(k));
+		};
+		const auto insert_range = [&](std::mt19937& rng, const int step)
+		{
+			std::vector<std::pair<int, int>> batch(rng() % 64);
+			for (auto& [k, v] : batch) k = key(rng), v = step;
+			m.insert_range(batch);
+			for (const auto& kv : batch) ref.insert(kv);
+		};
+		const auto bounds = [&](std::mt19937& rng, int)
+		{
+			const int k = key(rng);
+			ASSERT_EQ(m.lower_bound(k) - m.begin(), std::distance(ref.begin(), ref.lower_bound(k)));
+			ASSERT_EQ(m.upper_bound(k) - m.begin(), std::distance(ref.begin(), ref.upper_bound(k)));
+		};
+		const auto find = [&](std::mt19937& rng, int)
+		{
+			const int k = key(rng);
+			const auto it = m.find(k);
+			const auto r = ref.find(k);
+			ASSERT_EQ(it == m.end(), r == ref.end());
+			if (r != ref.end())
+			{
+				ASSERT_EQ(it->second, r->second);
+			}
+		};
+		const auto check = [&]
+		{
+			ASSERT_TRUE(std::equal(m.begin(), m.end(), ref.begin(), ref.end(),
+			                       [](const auto& a, const auto& b) { return a.first == b.first && a.second == b.second; }));
+		};
+
+		test::Fuzz(20000, 1000, check, try_emplace, erase, insert_range, bounds, find);
+	}
+}
+
+TEST(FlatMap, FuzzBranchless)
+{
+	FuzzMap<ostl::search::branchless>();
+}
+
+TEST(FlatMap, FuzzEytzinger)
+{
+	FuzzMap<ostl::search::eytzinger>();
+}
+
+TEST(FlatMap, Eytzinger)
+{
+	// Every size up to a few full levels, every gap between keys
+	for (auto n = 0; n < 300; ++n)
+	{
+		ostl::flat_set<int, std::less<int>, ostl::search::eytzinger> s;
+		std::vector<int> keys;
+		for (auto i = 0; i < n; ++i) keys.push_back(i * 2);
+		s.merge_sorted(keys);
+		for (auto x = -1; x <= n * 2; ++x)
+		{
+			ASSERT_EQ(s.lower_bound(x) - s.begin(), std::lower_bound(keys.begin(), keys.end(), x) - keys.begin());
+			ASSERT_EQ(s.upper_bound(x) - s.begin(), std::upper_bound(keys.begin(), keys.end(), x) - keys.begin());
+		}
+	}
+}
+
+TEST(FlatMap, Batch)
+{
+	ostl::flat_map<int, std::string> m{{5, "five"}, {1, "one"}};
+
+	// Keys already present and repeats within the batch keep the first value
+	const std::vector<std::pair<int, std::string>> batch{{3, "three"}, {5, "FIVE"}, {2, "two"}, {3, "THREE"}, {0, "zero"}};
+	m.insert_range(batch);
+	ASSERT_EQ(m.size(), 5);
+	ASSERT_TRUE(std::is_sorted(m.keys().begin(), m.keys().end()));
+	ASSERT_EQ(m.at(5), "five");
+	ASSERT_EQ(m.at(3), "three");
+	ASSERT_EQ(m.values().front(), "zero");
+
+	const std::vector<std::pair<int, std::string>> sorted{{4, "four"}, {6, "six"}, {7, "seven"}};
+	m.merge_sorted(sorted);
+	ASSERT_EQ(m.size(), 8);
+	for (auto i = 0; i < 8; ++i) ASSERT_EQ(m.begin()[i].first, i);
+
+	ostl::flat_map<int, std::string> from{ostl::vector<int>{2, 1}, ostl::vector<std::string>{"b", "a"}};
+	ASSERT_EQ(from.begin()->second, "a");
+	ASSERT_THROW((ostl::flat_map<int, int>{ostl::vector<int>{1}, ostl::vector<int>{}}), std::invalid_argument);
+
+	ASSERT_EQ(ostl::erase_if(m, [](const auto& kv) { return kv.first % 2; }), 4);
+	ASSERT_EQ(m.size(), 4);
+	ASSERT_FALSE(m.contains(3));
+	ASSERT_EQ(m.at(6), "six");
+}
+
+TEST(FlatMap, Interface)
+{
+	ostl::flat_map<std::string, int, std::less<>> m;
+	m["b"] = 2;
+	m[std::string{"a"}] = 1;
+	ASSERT_TRUE(m.try_emplace(std::string_view{"c"}, 3).second);
+	ASSERT_FALSE(m.insert_or_assign("c", 30).second);
+	ASSERT_FALSE(m.emplace("a", 10).second);
+	ASSERT_TRUE(m.insert({"d", 4}).second);
+
+	ASSERT_EQ(m.at(std::string_view{"c"}), 30);
+	ASSERT_EQ(m.find("a")->second, 1);
+	ASSERT_TRUE(m.contains(std::string_view{"d"}));
+	ASSERT_THROW((void)m.at("e"), std::out_of_range);
+	ASSERT_EQ(m.erase(std::string_view{"b"}), 1);
+	ASSERT_EQ(m.rbegin()->first, "d");
+
+	for (auto [k, v] : m) v *= 2;
+	ASSERT_EQ(m["a"], 2);
+
+	auto it = m.erase(m.find("a"));
+	ASSERT_EQ(it->first, "c");
+	ASSERT_EQ(m.equal_range("c").second - m.equal_range("c").first, 1);
+
+	const auto copy = m;
+	ASSERT_EQ(copy, m);
+	m["z"];
+	ASSERT_NE(copy, m);
+	auto moved = std::move(m);
+	ASSERT_EQ(moved.size(), 3);
+	swap(m, moved);
+	ASSERT_EQ(m.at("z"), 0);
+
+	auto [keys, values] = std::move(m).extract();
+	ASSERT_TRUE(m.empty());
+	ASSERT_EQ(keys.size(), 3);
+	m.replace(std::move(keys), std::move(values));
+	ASSERT_EQ(m.at("d"), 8);
+}
+
+TEST(FlatSet, Basic)
+{
+	ostl::flat_set<int> s{5, 3, 1, 3};
+	ASSERT_EQ(s.size(), 3);
+	ASSERT_TRUE(s.insert(2).second);
+	ASSERT_FALSE(s.insert(5).second);
+	ASSERT_EQ(*s.lower_bound(4), 5);
+	ASSERT_EQ(s.upper_bound(5), s.end());
+	ASSERT_EQ(s.erase(3), 1);
+	ASSERT_TRUE(std::equal(s.begin(), s.end(), std::vector<int>{1, 2, 5}.begin()));
+
+	std::set<int> ref(s.begin(), s.end());
+	std::mt19937 rng{7};
+	for (auto round = 0; round < 100; ++round)
+	{
+		std::vector<int> batch(rng() % 100);
+		for (auto& x : batch) x = static_cast<int>(rng() % 5000);
+		s.insert(batch.begin(), batch.end());
+		ref.insert(batch.begin(), batch.end());
+		ASSERT_TRUE(std::equal(s.begin(), s.end(), ref.begin(), ref.end()));
+	}
+
+	const auto n = std::erase_if(ref, [](int x) { return x % 3 == 0; });
+	ASSERT_EQ(ostl::erase_if(s, [](int x) { return x % 3 == 0; }), n);
+	ASSERT_TRUE(std::equal(s.begin(), s.end(), ref.begin(), ref.end()));
+
+	ostl::flat_set<std::string, std::less<>, ostl::search::eytzinger> names{"carol", "alice", "bob"};
+	ASSERT_TRUE(names.contains(std::string_view{"bob"}));
+	ASSERT_EQ(*names.begin(), "alice");
+	names.erase(names.begin());
+	ASSERT_FALSE(names.contains("alice"));
+	ASSERT_EQ(names.find("carol") - names.begin(), 1);
+}
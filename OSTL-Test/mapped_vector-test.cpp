@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+#include "OSTL/mapped_vector.h"
+
+#ifdef OSTL_HAS_MMAP
+
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+	struct Record
+	{
+		int64_t id;
+		double value;
+		char tag[4];
+	};
+
+	// Removes the file both before and after the test
+	struct TempFile
+	{
+		TempFile() : path{(std::filesystem::temp_directory_path() / ("ostl-mapped-" + std::to_string(::getpid()))).string()}
+		{
+			std::filesystem::remove(path);
+		}
+
+		~TempFile() { std::filesystem::remove(path); }
+
+		std::string path;
+	};
+}
+
+TEST(MappedVector, Persist)
+{
+	TempFile file;
+	{
+		ostl::mapped_vector<Record> v{file.path.c_str()};
+		ASSERT_TRUE(v.writable());
+		ASSERT_TRUE(v.empty());
+		for (auto i = 0; i < 100000; ++i) v.push_back({i, i * 0.5, {'a', 'b', 'c', '\0'}});
+		ASSERT_EQ(v.size(), 100000);
+		ASSERT_GE(v.capacity(), v.size());
+		v.sync();
+	}
+
+	ostl::mapped_vector<Record> v{file.path.c_str()};
+	ASSERT_EQ(v.size(), 100000);
+	for (auto i = 0; i < 100000; ++i)
+	{
+		ASSERT_EQ(v[i].id, i);
+		ASSERT_EQ(v[i].value, i * 0.5);
+	}
+	ASSERT_STREQ(v.back().tag, "abc");
+
+	v.emplace_back(v.front());
+	ASSERT_EQ(v.back().id, 0);
+	v.pop_back();
+
+	v.shrink_to_fit();
+	ASSERT_EQ(std::filesystem::file_size(file.path) % ::sysconf(_SC_PAGESIZE), 0);
+	ASSERT_LT(std::filesystem::file_size(file.path), 64 + v.size() * sizeof(Record) + ::sysconf(_SC_PAGESIZE));
+	ASSERT_THROW((void)v.at(100000), std::out_of_range);
+}
+
+TEST(MappedVector, Interface)
+{
+	TempFile file;
+	ostl::mapped_vector<int> v{file.path.c_str()};
+
+	const std::vector<int> src{1, 2, 3, 4, 5};
+	v.append_range(src);
+	v.append(src.rbegin(), src.rend());
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), std::vector<int>{1, 2, 3, 4, 5, 5, 4, 3, 2, 1}.begin()));
+	ASSERT_EQ(std::accumulate(v.cbegin(), v.cend(), 0), 30);
+	ASSERT_EQ(*v.rbegin(), 1);
+
+	for (auto& x : v) x *= 2;
+	ASSERT_EQ(v[4], 10);
+
+	v.resize(3);
+	v.resize(6, 7);
+	ASSERT_TRUE(std::equal(v.begin(), v.end(), std::vector<int>{2, 4, 6, 7, 7, 7}.begin()));
+
+	v.reserve(1 << 20);
+	ASSERT_GE(v.capacity(), 1 << 20);
+	ASSERT_EQ(v[5], 7);
+
+	auto moved = std::move(v);
+	ASSERT_FALSE(v.is_open());
+	ASSERT_EQ(moved.size(), 6);
+	moved.clear();
+	ASSERT_TRUE(moved.empty());
+}
+
+TEST(MappedVector, ReadOnly)
+{
+	TempFile file;
+	ostl::mapped_vector<int> writer{file.path.c_str()};
+	for (auto i = 0; i < 1000; ++i) writer.push_back(i);
+
+	const ostl::mapped_vector<int> reader{file.path.c_str(), ostl::mapped_vector<int>::mode::read_only};
+	ASSERT_FALSE(reader.writable());
+	ASSERT_EQ(reader.size(), 1000);
+	ASSERT_EQ(reader[999], 999);
+
+	// Both map the same pages
+	writer[10] = -1;
+	ASSERT_EQ(reader[10], -1);
+
+	auto& r = const_cast<ostl::mapped_vector<int>&>(reader);
+	ASSERT_THROW(r.push_back(0), std::logic_error);
+	ASSERT_THROW(r.clear(), std::logic_error);
+	ASSERT_THROW(r.reserve(5000), std::logic_error);
+}
+
+TEST(MappedVector, BadFile)
+{
+	TempFile file;
+	using mode = ostl::mapped_vector<int>::mode;
+	ASSERT_THROW((ostl::mapped_vector<int>{file.path.c_str(), mode::read_only}), std::system_error);
+
+	{
+		ostl::mapped_vector<int> v{file.path.c_str()};
+		v.push_back(1);
+	}
+	ASSERT_THROW(ostl::mapped_vector<double>{file.path.c_str()}, std::invalid_argument);
+
+	std::ofstream{file.path, std::ios::trunc} << "not a mapped vector";
+	ASSERT_THROW((ostl::mapped_vector<int>{file.path.c_str(), mode::read_only}), std::invalid_argument);
+}
+
+#endif
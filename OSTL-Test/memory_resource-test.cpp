@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "OSTL/memory_resource.h"
+#include "OSTL/vector.h"
+#include "test_util.h"
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace
+{
+	using test::CountingResource;
+
+	bool IsAligned(const void* p, const size_t align) { return reinterpret_cast<uintptr_t>(p) % align == 0; }
+}
+
+TEST(MemoryResource, Monotonic)
+{
+	CountingResource upstream;
+	{
+		alignas(16) char buffer[256];
+		ostl::pmr::monotonic_buffer_resource mono{ buffer, sizeof buffer, &upstream };
+		void* p = mono.allocate(100, 16);
+		ASSERT_TRUE(p >= buffer && p < buffer + sizeof buffer);
+		ASSERT_EQ(upstream.calls, 0);
+
+		{
+			ostl::pmr::vector<int> v{ &mono };
+			for (auto i = 0; i < 100000; ++i) v.push_back(i);
+			ASSERT_EQ(v[99999], 99999);
+			ASSERT_LT(upstream.calls, 25);
+		}
+		ASSERT_TRUE(IsAligned(mono.allocate(8, 64), 64));
+
+		mono.release();
+		ASSERT_EQ(upstream.outstanding(), 0);
+		ASSERT_TRUE(mono.allocate(8) >= static_cast<void*>(buffer));
+		(void)mono.allocate(10000);
+	}
+	ASSERT_EQ(upstream.outstanding(), 0);
+}
+
+TEST(MemoryResource, MonotonicHugeRequest)
+{
+	alignas(16) char buffer[256];
+	ostl::pmr::monotonic_buffer_resource mono{ buffer, sizeof buffer, std::pmr::null_memory_resource() };
+
+	// Neither may wrap the chunk size around and loop or serve a chunk that is too small
+	ASSERT_THROW((void)mono.allocate(size_t(-1) - 8), std::bad_alloc);
+	ASSERT_THROW((void)mono.allocate(size_t(-1) / 2, 64), std::bad_alloc);
+	ASSERT_THROW((void)mono.allocate(size_t(-1) / 4), std::bad_alloc);
+
+	void* p = mono.allocate(100);
+	ASSERT_TRUE(p >= buffer && p < buffer + sizeof buffer);
+}
+
+TEST(MemoryResource, UnsynchronizedPool)
+{
+	CountingResource upstream;
+	{
+		ostl::pmr::unsynchronized_pool_resource pool{ &upstream };
+		ASSERT_EQ(pool.options().largest_required_pool_block, 4096);
+
+		void* a = pool.allocate(24);
+		pool.deallocate(a, 24);
+		ASSERT_EQ(pool.allocate(20), a);
+
+		for (size_t size : { 1, 8, 9, 100, 1000, 4096, 5000, 100000 })
+		{
+			for (size_t align : { 1, 8, 64, 256 })
+			{
+				void* p = pool.allocate(size, align);
+				ASSERT_TRUE(IsAligned(p, align));
+				std::memset(p, 0xab, size);
+				if (size % 3) pool.deallocate(p, size, align);
+			}
+		}
+
+		{
+			ostl::pmr::vector<int> v{ &pool };
+			for (auto i = 0; i < 10000; ++i) v.push_back(i);
+		}
+
+		pool.release();
+		ASSERT_EQ(upstream.outstanding(), 0);
+		(void)pool.allocate(10);
+		(void)pool.allocate(1 << 20);
+	}
+	ASSERT_EQ(upstream.outstanding(), 0);
+}
+
+TEST(MemoryResource, SynchronizedPool)
+{
+	CountingResource upstream;
+	{
+		ostl::pmr::synchronized_pool_resource pool{ &upstream };
+
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&pool, t]
+			{
+				std::mt19937 rng{ t };
+				std::vector<std::pair<unsigned char*, size_t>> live;
+				for (auto i = 0; i < 20000; ++i)
+				{
+					if (live.empty() || rng() % 3)
+					{
+						const size_t size = 1 + rng() % (rng() % 16 ? 200 : 10000);
+						const auto p = static_cast<unsigned char*>(pool.allocate(size));
+						std::memset(p, static_cast<int>(size & 0xff), size);
+						live.emplace_back(p, size);
+					}
+					else
+					{
+						const auto j = rng() % live.size();
+						const auto [p, size] = live[j];
+						for (size_t k = 0; k < size; ++k)
+							ASSERT_EQ(p[k], size & 0xff);
+						pool.deallocate(p, size);
+						live[j] = live.back();
+						live.pop_back();
+					}
+				}
+				for (const auto& [p, size] : live) pool.deallocate(p, size);
+			});
+		}
+		for (auto& t : threads) t.join();
+
+		ostl::pmr::vector<int> v{ &pool };
+		for (auto i = 0; i < 10000; ++i) v.push_back(i);
+		ASSERT_EQ(v[9999], 9999);
+	}
+	ASSERT_EQ(upstream.outstanding(), 0);
+
+	// Blocks cached by this thread for a dead resource must not leak into a new one
+	ostl::pmr::synchronized_pool_resource second{ &upstream };
+	void* p = second.allocate(32);
+	second.deallocate(p, 32);
+	second.release();
+	p = second.allocate(32);
+	second.deallocate(p, 32);
+}
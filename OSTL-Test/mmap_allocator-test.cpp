@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include "OSTL/mmap_allocator.h"
+#include "OSTL/string.h"
+#include "OSTL/vector.h"
+
+namespace
+{
+	// Small threshold so that the mapped path is exercised without gigabytes
+	template <class T, bool Populate = false>
+	using small_mmap_allocator = ostl::mmap_allocator<T, Populate, 64 * 1024>;
+}
+
+TEST(MmapAllocator, Vector)
+{
+	ostl::vector<int, small_mmap_allocator<int>> v;
+	for (auto i = 0; i < 1000; ++i) v.push_back(i);
+	ASSERT_LT(v.capacity() * sizeof(int), 64 * 1024);
+
+	for (auto i = 1000; i < 2000000; ++i) v.push_back(i);
+	ASSERT_EQ(v.capacity() * sizeof(int) % small_mmap_allocator<int>::huge_page, 0);
+	ASSERT_EQ(reinterpret_cast<uintptr_t>(v.data()) % small_mmap_allocator<int>::huge_page, 0);
+	for (auto i = 0; i < 2000000; ++i)
+		ASSERT_EQ(v[i], i);
+
+	v.resize(100);
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), 100);
+	ASSERT_EQ(v[99], 99);
+
+	ostl::vector<int, small_mmap_allocator<int, true>> populated(100000, 7);
+	ASSERT_EQ(populated[99999], 7);
+
+	ostl::vector<bool, small_mmap_allocator<bool>> bits(10000000, true);
+	ASSERT_EQ(bits.count(), 10000000);
+}
+
+TEST(MmapAllocator, Reallocate)
+{
+	using alloc = small_mmap_allocator<int>;
+	alloc a;
+	auto r = a.allocate_at_least(100000);
+	for (auto i = 0; i < 100000; ++i) r.ptr[i] = i;
+
+	for (auto round = 0; round < 8; ++round)
+	{
+		// Every other round, occupy the page after the block so that it has to move
+#ifdef MAP_FIXED_NOREPLACE
+		void* const blocker = round % 2
+			? ::mmap(r.ptr + r.count, 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+			: MAP_FAILED;
+#endif
+		const size_t old_n = r.count, n = old_n + 1;
+		r = a.reallocate(r.ptr, old_n, n);
+#ifdef MAP_FIXED_NOREPLACE
+		if (blocker != MAP_FAILED) ::munmap(blocker, 4096);
+#endif
+
+		ASSERT_GE(r.count, n);
+		ASSERT_EQ(reinterpret_cast<uintptr_t>(r.ptr) % alloc::huge_page, 0);
+		for (auto i = 0; i < 100000; ++i)
+			ASSERT_EQ(r.ptr[i], i);
+	}
+
+	// Shrinking stays in place
+	const auto p = r.ptr;
+	r = a.reallocate(r.ptr, r.count, 100000);
+	ASSERT_EQ(r.ptr, p);
+	ASSERT_EQ(r.ptr[99999], 99999);
+	a.deallocate(r.ptr, r.count);
+}
+
+TEST(MmapAllocator, String)
+{
+	ostl::basic_string<char, std::char_traits<char>, ostl::mmap_allocator<char>> str;
+	(void)str;
+}
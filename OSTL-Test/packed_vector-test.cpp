@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+#include "OSTL/packed_vector.h"
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	template <unsigned Bits>
+	void TestRandomOps()
+	{
+		using packed = ostl::packed_vector<Bits>;
+		using T = typename packed::value_type;
+		std::mt19937_64 rng{ Bits };
+		const auto value = [&] { return static_cast<T>(rng() & packed::max_value); };
+
+		packed v;
+		std::vector<T> ref;
+		for (auto i = 0; i < 3000; ++i)
+		{
+			const T x = value();
+			v.push_back(x);
+			ref.push_back(x);
+		}
+
+		for (auto round = 0; round < 40; ++round)
+		{
+			const size_t pos = rng() % (ref.size() + 1);
+			switch (rng() % 4)
+			{
+			case 0:
+			{
+				const size_t n = rng() % 200;
+				const T x = value();
+				v.insert(v.begin() + pos, n, x);
+				ref.insert(ref.begin() + pos, n, x);
+				break;
+			}
+			case 1:
+			{
+				std::vector<T> src(rng() % 300);
+				for (auto& x : src) x = value();
+				v.insert(v.begin() + pos, src.data(), src.data() + src.size());
+				ref.insert(ref.begin() + pos, src.begin(), src.end());
+				break;
+			}
+			case 2:
+			{
+				const size_t last = std::min(ref.size(), pos + rng() % 300);
+				v.erase(v.begin() + pos, v.begin() + last);
+				ref.erase(ref.begin() + pos, ref.begin() + last);
+				break;
+			}
+			default:
+			{
+				const size_t first = rng() % (ref.size() + 1), last = std::min(ref.size(), first + rng() % 300);
+				v.insert(v.begin() + pos, v.begin() + first, v.begin() + last);
+				const std::vector<T> range(ref.begin() + first, ref.begin() + last);
+				ref.insert(ref.begin() + pos, range.begin(), range.end());
+				break;
+			}
+			}
+			ASSERT_EQ(v.size(), ref.size());
+		}
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+
+		std::vector<T> out(ref.size());
+		for (size_t first : { size_t{0}, size_t{1}, size_t{7}, ref.size() / 3 })
+		{
+			std::fill(out.begin(), out.end(), T{});
+			v.unpack(first, ref.size() - first, out.data());
+			ASSERT_TRUE(std::equal(ref.begin() + first, ref.end(), out.begin()));
+		}
+
+		std::vector<T> in(500);
+		for (auto& x : in) x = value();
+		v.pack(13, in.size(), in.data());
+		std::copy(in.begin(), in.end(), ref.begin() + 13);
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+
+		v.append(in.data(), in.size());
+		ref.insert(ref.end(), in.begin(), in.end());
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), ref.begin(), ref.end()));
+		ASSERT_TRUE(packed(v) == v);
+	}
+
+	// Every start phase and a spread of lengths, checking the elements around the range are kept
+	template <unsigned Bits>
+	void TestPack()
+	{
+		using packed = ostl::packed_vector<Bits>;
+		using T = typename packed::value_type;
+		std::mt19937_64 rng{ Bits };
+
+		std::vector<T> in(300);
+		for (auto& x : in) x = static_cast<T>(rng());
+		std::vector<T> ref(400);
+		for (auto& x : ref) x = static_cast<T>(rng() & packed::max_value);
+
+		for (size_t pos = 0; pos < 16; ++pos)
+		{
+			for (const size_t n : { size_t{0}, size_t{1}, size_t{7}, size_t{8}, size_t{23}, size_t{64}, size_t{65}, size_t{300} })
+			{
+				packed v(ref.begin(), ref.end());
+				v.pack(pos, n, in.data());
+				std::vector<T> expected = ref;
+				for (size_t i = 0; i < n; ++i) expected[pos + i] = static_cast<T>(in[i] & packed::max_value);
+				ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end())) << pos << ' ' << n;
+			}
+		}
+	}
+}
+
+TEST(PackedVector, RandomOps)
+{
+	TestRandomOps<1>();
+	TestRandomOps<3>();
+	TestRandomOps<7>();
+	TestRandomOps<8>();
+	TestRandomOps<12>();
+	TestRandomOps<20>();
+	TestRandomOps<25>();
+	TestRandomOps<31>();
+	TestRandomOps<33>();
+	TestRandomOps<64>();
+}
+
+TEST(PackedVector, Pack)
+{
+	TestPack<1>();
+	TestPack<3>();
+	TestPack<7>();
+	TestPack<8>();
+	TestPack<12>();
+	TestPack<16>();
+	TestPack<20>();
+	TestPack<25>();
+	TestPack<31>();
+	TestPack<64>();
+}
+
+TEST(PackedVector, Basic)
+{
+	ostl::packed_vector<5> v{ 1, 2, 31, 4 };
+	ASSERT_EQ(v.size(), 4);
+	ASSERT_EQ(v[2], 31);
+	v[2] = 40;
+	ASSERT_EQ(v[2], 40 & 31);
+	v.back() = v.front();
+	ASSERT_EQ(v[3], 1);
+	ASSERT_GE(v.capacity(), 4);
+	ASSERT_LE(v.capacity() * 5, v.capacity() * 5 / 64 * 64 + 64);
+
+	v.resize(100, 9);
+	ASSERT_EQ(v[99], 9);
+	v.resize(3);
+	ASSERT_TRUE(v == (ostl::packed_vector<5>{ 1, 2, 8 }));
+	ASSERT_TRUE(v < (ostl::packed_vector<5>{ 1, 3 }));
+
+	std::istringstream in{ "4 5 6" };
+	v.insert(v.begin() + 1, std::istream_iterator<int>{ in }, std::istream_iterator<int>{});
+	ASSERT_TRUE(v == (ostl::packed_vector<5>{ 1, 4, 5, 6, 2, 8 }));
+
+	v.assign(70, 17);
+	ASSERT_EQ(std::count(v.begin(), v.end(), 17), 70);
+	ASSERT_THROW((void)v.at(70), std::out_of_range);
+}
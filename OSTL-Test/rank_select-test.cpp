@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include "OSTL/rank_select.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+	void AssertIndexed(const ostl::rank_select<>& rs, const ostl::vector<bool>& bits)
+	{
+		std::vector<size_t> ones;
+		ASSERT_EQ(rs.size(), bits.size());
+		for (size_t i = 0; i < bits.size(); ++i)
+		{
+			ASSERT_EQ(rs.rank1(i), ones.size());
+			if (bits[i]) ones.push_back(i);
+		}
+		ASSERT_EQ(rs.rank1(bits.size()), ones.size());
+		ASSERT_EQ(rs.count(), ones.size());
+
+		for (size_t k = 0; k < ones.size(); ++k)
+			ASSERT_EQ(rs.select1(k), ones[k]);
+		ASSERT_EQ(rs.select1(ones.size()), ostl::rank_select<>::npos);
+	}
+}
+
+TEST(RankSelect, Dense)
+{
+	std::mt19937 rng{ 7 };
+	ostl::vector<bool> bits;
+	for (auto i = 0; i < 50000; ++i) bits.push_back(rng() % 3 != 0);
+
+	const ostl::rank_select<> rs{ bits };
+	AssertIndexed(rs, bits);
+	ASSERT_EQ(rs.rank0(1000), 1000 - rs.rank1(1000));
+}
+
+TEST(RankSelect, Sparse)
+{
+	std::mt19937 rng{ 8 };
+	ostl::vector<bool> bits(100000, false);
+	for (auto i = 0; i < 40; ++i) bits[rng() % bits.size()] = true;
+	bits.resize(100003);
+
+	AssertIndexed(ostl::rank_select<>{ bits }, bits);
+	AssertIndexed(ostl::rank_select<>{ ostl::vector<bool>{} }, ostl::vector<bool>{});
+}
+
+TEST(RankSelect, Append)
+{
+	std::mt19937 rng{ 9 };
+	ostl::vector<bool> bits;
+	ostl::rank_select<> rs;
+	for (auto round = 0; round < 6; ++round)
+	{
+		const size_t n = rng() % 5000;
+		for (size_t i = 0; i < n; ++i) bits.push_back(rng() & 1);
+		rs.update(bits);
+		AssertIndexed(rs, bits);
+	}
+
+	bits.resize(bits.size() + 20000, true);
+	rs.update(bits);
+	AssertIndexed(rs, bits);
+}
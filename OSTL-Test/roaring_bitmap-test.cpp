@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "OSTL/roaring_bitmap.h"
+#include <random>
+#include <set>
+#include <sstream>
+
+namespace
+{
+	void AssertSame(const ostl::roaring_bitmap& r, const std::set<uint32_t>& ref)
+	{
+		ASSERT_EQ(r.cardinality(), ref.size());
+		ASSERT_TRUE(std::equal(r.begin(), r.end(), ref.begin(), ref.end()));
+	}
+
+	// Dense cluster, sparse scatter and a long run, spread over a few chunks
+	void Fill(ostl::roaring_bitmap& r, std::set<uint32_t>& ref, const unsigned seed)
+	{
+		std::mt19937 rng{ seed };
+		for (auto i = 0; i < 10000; ++i)
+		{
+			const uint32_t x = 0x30000 + rng() % 12000;
+			r.add(x);
+			ref.insert(x);
+		}
+		for (auto i = 0; i < 500; ++i)
+		{
+			const uint32_t x = rng();
+			r.add(x);
+			ref.insert(x);
+		}
+		const uint32_t first = 0x7fff0 + rng() % 100;
+		r.add_range(first, first + 70000);
+		for (uint32_t x = first; x < first + 70000; ++x) ref.insert(x);
+	}
+}
+
+TEST(RoaringBitmap, AddRemove)
+{
+	ostl::roaring_bitmap r;
+	std::set<uint32_t> ref;
+	Fill(r, ref, 1);
+	AssertSame(r, ref);
+
+	std::mt19937 rng{ 2 };
+	for (auto i = 0; i < 8000; ++i)
+	{
+		const uint32_t x = 0x30000 + rng() % 12000;
+		r.remove(x);
+		ref.erase(x);
+	}
+	AssertSame(r, ref);
+
+	for (uint32_t x = 0x2ffff; x < 0x34000; ++x)
+		ASSERT_EQ(r.contains(x), ref.count(x) != 0);
+
+	r.run_optimize();
+	AssertSame(r, ref);
+	for (uint32_t x = 0x7ff00; x < 0x91000; ++x)
+		ASSERT_EQ(r.contains(x), ref.count(x) != 0);
+
+	r.add(0x80000 + 3);
+	r.remove(0x80000 + 5);
+	ref.insert(0x80000 + 3);
+	ref.erase(0x80000 + 5);
+	AssertSame(r, ref);
+
+	for (const auto x : ref) r.remove(x);
+	ASSERT_TRUE(r.empty());
+}
+
+TEST(RoaringBitmap, SetAlgebra)
+{
+	ostl::roaring_bitmap a, b;
+	std::set<uint32_t> ra, rb;
+	Fill(a, ra, 3);
+	Fill(b, rb, 4);
+	b.run_optimize();
+
+	std::set<uint32_t> un, in;
+	std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(un, un.end()));
+	std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), std::inserter(in, in.end()));
+
+	AssertSame(a | b, un);
+	AssertSame(a & b, in);
+	AssertSame(b & a, in);
+
+	auto c = a;
+	c |= c;
+	c &= c;
+	ASSERT_TRUE(c == a);
+	ASSERT_TRUE((ostl::roaring_bitmap{ 1, 2, 3 } & ostl::roaring_bitmap{ 0x10002 }).empty());
+}
+
+TEST(RoaringBitmap, Serialize)
+{
+	ostl::roaring_bitmap r;
+	std::set<uint32_t> ref;
+	Fill(r, ref, 5);
+	r.run_optimize();
+	r.add(0xffffffff);
+	ref.insert(0xffffffff);
+
+	std::stringstream ss;
+	r.serialize(ss);
+	const auto copy = ostl::roaring_bitmap::deserialize(ss);
+	ASSERT_TRUE(copy == r);
+	AssertSame(copy, ref);
+
+	std::istringstream bad{ ss.str().substr(0, 20) };
+	ASSERT_THROW((void)ostl::roaring_bitmap::deserialize(bad), std::invalid_argument);
+}
+
+namespace
+{
+	// Stream with one chunk of the given kind, cardinality and u16 payload
+	std::istringstream OneChunk(const uint8_t kind, const uint32_t card, std::initializer_list<uint16_t> payload)
+	{
+		std::string s;
+		const auto put = [&](uint64_t v, int bytes) { while (bytes--) s += static_cast<char>(v & 0xff), v >>= 8; };
+		put(0x31425230, 4);
+		put(1, 4);
+		put(0, 2);
+		put(kind, 1);
+		put(card, 4);
+		for (const auto v : payload) put(v, 2);
+		return std::istringstream{s};
+	}
+
+	void Load(std::istringstream is)
+	{
+		(void)ostl::roaring_bitmap::deserialize(is);
+	}
+}
+
+TEST(RoaringBitmap, CorruptStream)
+{
+	ASSERT_THROW(Load(OneChunk(2, 0x10000, {1, 65535, 65535})), std::invalid_argument);  // run past the chunk
+	ASSERT_THROW(Load(OneChunk(2, 1, {0})), std::invalid_argument);                      // no runs
+	ASSERT_THROW(Load(OneChunk(2, 5, {1, 10, 3})), std::invalid_argument);               // wrong cardinality
+	ASSERT_THROW(Load(OneChunk(2, 4, {2, 5, 1, 4, 1})), std::invalid_argument);          // overlapping runs
+	ASSERT_THROW(Load(OneChunk(0, 3, {1, 3, 2})), std::invalid_argument);                // unsorted array
+	ASSERT_THROW(Load(OneChunk(0, 2, {4, 4})), std::invalid_argument);                   // repeated value
+
+	auto ok = OneChunk(2, 6, {2, 10, 2, 20, 2});
+	auto r = ostl::roaring_bitmap::deserialize(ok);
+	ASSERT_EQ(r.cardinality(), 6);
+	r.add(65535);
+	ASSERT_TRUE(r.contains(22));
+	ASSERT_FALSE(r.contains(13));
+}
+
+TEST(RoaringBitmap, AddRangeBounds)
+{
+	ostl::roaring_bitmap r;
+	r.add_range(0xfffffff0, 0x100000000);
+	ASSERT_EQ(r.cardinality(), 16);
+	ASSERT_TRUE(r.contains(0xffffffff));
+	ASSERT_THROW(r.add_range(0xfffffff0, 0x100000001), std::out_of_range);
+	ASSERT_EQ(r.cardinality(), 16);
+}
@@ -0,0 +1,173 @@
+#include "gtest/gtest.h"
+#include "OSTL/soa_vector.h"
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	using Particles = ostl::soa_vector<float, double, int, std::string>;
+
+	void ExpectAligned(const void* p)
+	{
+		ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % Particles::column_alignment, 0);
+	}
+}
+
+TEST(SoaVector, Columns)
+{
+	Particles v;
+	for (auto i = 0; i < 1000; ++i) v.emplace_back(i * 1.f, i * 2., i, std::to_string(i));
+	ASSERT_EQ(v.size(), 1000);
+	ASSERT_GE(v.capacity(), 1000);
+
+	ExpectAligned(v.data<0>());
+	ExpectAligned(v.data<1>());
+	ExpectAligned(v.data<2>());
+	ExpectAligned(v.data<3>());
+
+	const auto ints = v.column<2>();
+	ASSERT_EQ(ints.size(), 1000);
+	ASSERT_EQ(std::accumulate(ints.begin(), ints.end(), 0), 999 * 1000 / 2);
+
+	for (auto& x : v.column<0>()) x *= 2;
+	ASSERT_EQ(std::get<0>(v[10]), 20.f);
+	ASSERT_EQ(std::get<3>(v.back()), "999");
+}
+
+TEST(SoaVector, Rows)
+{
+	Particles v{{1.f, 2., 3, "a"}, {4.f, 5., 6, "b"}};
+	ASSERT_EQ(v.size(), 2);
+
+	auto [f, d, i, s] = v[1];
+	ASSERT_EQ(f, 4.f);
+	s = "changed";
+	ASSERT_EQ(std::get<3>(v[1]), "changed");
+
+	// Zip iteration yields tuples of references
+	for (auto&& [x, y, n, str] : v) n *= 10;
+	ASSERT_EQ(std::get<2>(v[0]), 30);
+
+	const Particles::value_type row = *v.begin();
+	ASSERT_EQ(row, (Particles::value_type{1.f, 2., 30, "a"}));
+	ASSERT_EQ(v.end() - v.begin(), 2);
+	ASSERT_EQ(std::get<2>(*v.rbegin()), 60);
+	ASSERT_THROW((void)v.at(2), std::out_of_range);
+
+	v.push_back(row);
+	v.push_back(Particles::value_type{7.f, 8., 9, "c"});
+	ASSERT_EQ(std::get<3>(v.back()), "c");
+
+	// Arguments that alias a row survive the reallocation
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), v.size());
+	v.emplace_back(std::get<0>(v[0]), std::get<1>(v[0]), std::get<2>(v[0]), std::get<3>(v[0]));
+	ASSERT_EQ(v.back(), v.front());
+}
+
+TEST(SoaVector, Modifiers)
+{
+	ostl::soa_vector<int, std::string> v;
+	for (auto i = 0; i < 10; ++i) v.emplace_back(i, std::to_string(i));
+
+	auto it = v.erase(v.begin() + 2, v.begin() + 5);
+	ASSERT_EQ(std::get<0>(*it), 5);
+	ASSERT_EQ(v.size(), 7);
+	ASSERT_EQ(std::get<1>(v[2]), "5");
+
+	it = v.insert(v.begin() + 1, {100, "x"});
+	ASSERT_EQ(std::get<0>(*it), 100);
+	ASSERT_EQ(std::get<1>(v[2]), "1");
+	ASSERT_EQ(v.size(), 8);
+
+	v.pop_back();
+	ASSERT_EQ(std::get<0>(v.back()), 8);
+
+	v.resize(20);
+	ASSERT_EQ(std::get<1>(v.back()), "");
+	v.resize(25, {7, "y"});
+	ASSERT_EQ(std::get<1>(v.back()), "y");
+	v.resize(3);
+	ASSERT_EQ(v.size(), 3);
+
+	auto copy = v;
+	ASSERT_EQ(copy, v);
+	auto moved = std::move(copy);
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(moved, v);
+
+	v.clear();
+	ASSERT_TRUE(v.empty());
+	ASSERT_NE(moved, v);
+}
+
+namespace
+{
+	// Move construction throws once the countdown reaches zero
+	struct ThrowOnMove
+	{
+		static inline int moves_left = -1;
+
+		explicit ThrowOnMove(const int v) : value{v} {}
+		ThrowOnMove(const ThrowOnMove&) = default;
+		ThrowOnMove(ThrowOnMove&& x) : value{x.value} { if (moves_left >= 0 && moves_left-- == 0) throw std::runtime_error{""}; }
+		ThrowOnMove& operator=(const ThrowOnMove&) = default;
+		int value;
+	};
+
+	// Counts copies, and copy construction throws once the countdown reaches zero
+	struct CountCopies
+	{
+		static inline int copies = 0;
+		static inline int copies_left = -1;
+
+		explicit CountCopies(const int v) : value{v} {}
+		CountCopies(const CountCopies& x) : value{x.value}
+		{
+			if (copies_left >= 0 && copies_left-- == 0) throw std::runtime_error{""};
+			++copies;
+		}
+		CountCopies& operator=(const CountCopies&) = default;
+		bool operator==(const CountCopies&) const = default;
+		int value;
+	};
+}
+
+TEST(SoaVector, InsertThrows)
+{
+	ostl::soa_vector<std::string, ThrowOnMove> v;
+	v.reserve(16);
+	for (auto i = 0; i < 5; ++i) v.emplace_back(std::to_string(i), ThrowOnMove{i});
+
+	// Shifting the last three rows takes three moves; building the new row is the fourth
+	const std::tuple<std::string, ThrowOnMove> row{"new", ThrowOnMove{100}};
+	ThrowOnMove::moves_left = 3;
+	ASSERT_THROW(v.insert(v.begin() + 2, row), std::runtime_error);
+	ThrowOnMove::moves_left = -1;
+
+	ASSERT_EQ(v.size(), 5);
+	for (auto i = 0; i < 5; ++i)
+	{
+		ASSERT_EQ(v.column<0>()[i], std::to_string(i));
+		ASSERT_EQ(v.column<1>()[i].value, i);
+	}
+}
+
+TEST(SoaVector, CopyConstruct)
+{
+	using soa = ostl::soa_vector<std::string, CountCopies>;
+	soa v;
+	for (auto i = 0; i < 100; ++i) v.emplace_back(std::to_string(i), CountCopies{i});
+
+	// Each row is copied once, straight into place
+	CountCopies::copies = 0;
+	const auto copy = v;
+	ASSERT_EQ(CountCopies::copies, 100);
+	ASSERT_EQ(copy, v);
+
+	// A throwing copy leaves nothing behind
+	CountCopies::copies_left = 50;
+	ASSERT_THROW(soa{v}, std::runtime_error);
+	CountCopies::copies_left = -1;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "gtest/gtest.h"
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+
+namespace test
+{
+	// Tracks outstanding blocks and checks deallocate calls against them, so freeing through the wrong
+	// resource fails the test
+	class CountingResource : public std::pmr::memory_resource
+	{
+	public:
+		size_t calls = 0;
+
+		[[nodiscard]] size_t outstanding() const
+		{
+			std::lock_guard lock{mutex_};
+			return blocks_.size();
+		}
+
+	private:
+		void* do_allocate(const size_t bytes, const size_t align) override
+		{
+			void* p = std::pmr::new_delete_resource()->allocate(bytes, align);
+			std::lock_guard lock{mutex_};
+			++calls;
+			blocks_[p] = { bytes, align };
+			return p;
+		}
+
+		void do_deallocate(void* p, const size_t bytes, const size_t align) override
+		{
+			{
+				std::lock_guard lock{mutex_};
+				const auto it = blocks_.find(p);
+				if (it == blocks_.end())
+				{
+					ADD_FAILURE() << "block freed through a resource that did not allocate it";
+					return;
+				}
+				EXPECT_EQ(it->second, std::make_pair(bytes, align));
+				blocks_.erase(it);
+			}
+			std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+		}
+
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+		mutable std::mutex mutex_;
+		std::map<void*, std::pair<size_t, size_t>> blocks_;
+	};
+
+	// Runs random operations against a container and its std reference. Each step calls one of ops, picked
+	// uniformly, with the generator and the step number; an op listed twice is picked twice as often. check
+	// compares the two every check_every steps and at the end.
+	template <class Check, class... Ops>
+	void Fuzz(const int steps, const int check_every, Check check, Ops... ops)
+	{
+		std::mt19937 rng{42};
+		for (auto step = 0; step < steps; ++step)
+		{
+			const size_t pick = rng() % sizeof...(Ops);
+			size_t k = 0;
+			((k++ == pick ? ops(rng, step) : void()), ...);
+			if (step % check_every == 0) check();
+			if (::testing::Test::HasFatalFailure()) return;
+		}
+		check();
+	}
+}
@@ -1,5 +1,15 @@
 #include "gtest/gtest.h"
 #include "OSTL/vector.h"
+#include "OSTL/malloc_allocator.h"
+#include "test_util.h"
+#include <cstring>
+#include <list>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
 
 template <typename T>
 void AssertAllEqual(const ostl::vector<T>& actual, std::initializer_list<T> expected) {
@@ -62,6 +72,29 @@ TEST(Vector, Assign) {
 	AssertAllEqual(nums1, 3);
 }
 
+TEST(Vector, AssignAcrossResources) {
+	test::CountingResource r1, r2;
+	{
+		ostl::vector<std::string, std::pmr::polymorphic_allocator<std::string>> a{ &r1 }, b{ &r2 }, c{ &r2 };
+		for (auto i = 0; i < 100; ++i) a.push_back(std::to_string(i));
+
+		// polymorphic_allocator does not propagate, so the buffers stay with their own resource
+		b = a;
+		ASSERT_EQ(b, a);
+		ASSERT_EQ(b.get_allocator().resource(), &r2);
+
+		c = std::move(a);
+		ASSERT_EQ(c, b);
+		ASSERT_TRUE(a.empty());
+
+		const auto data = c.data();
+		b = std::move(c);
+		ASSERT_EQ(b.data(), data);
+	}
+	ASSERT_EQ(r1.outstanding(), 0);
+	ASSERT_EQ(r2.outstanding(), 0);
+}
+
 TEST(Vector, ElementAccess) {
 	ostl::vector<int> numbers{ 2,4,6,8 };
 	ASSERT_THROW(numbers.at(4), std::out_of_range);
@@ -123,6 +156,33 @@ TEST(Vector, Insert) {
 	AssertAllEqual(vec, { 501,502,503,300,300,400,400,200,100,100,100,6,9,7,4 });
 }
 
+TEST(Vector, InsertRange) {
+	ostl::vector<int> vec{ 1, 2, 3, 4 };
+	const std::list<int> list{ 7, 8, 9 };
+
+	const auto it = vec.insert(vec.begin() + 2, list.begin(), list.end());
+	ASSERT_EQ(*it, 7);
+	AssertAllEqual(vec, { 1, 2, 7, 8, 9, 3, 4 });
+
+	vec.append_range(std::views::iota(10, 13));
+	AssertAllEqual(vec, { 1, 2, 7, 8, 9, 3, 4, 10, 11, 12 });
+
+	vec.insert_range(vec.begin(), ostl::vector<int>{ 5, 6 });
+	AssertAllEqual(vec, { 5, 6, 1, 2, 7, 8, 9, 3, 4, 10, 11, 12 });
+
+	vec.reserve(20);
+	const auto cap = vec.capacity();
+	vec.append_range(list);
+	ASSERT_EQ(vec.capacity(), cap);
+
+	vec.assign_range(list);
+	AssertAllEqual(vec, { 7, 8, 9 });
+
+	std::istringstream in{ "4 5 6" };
+	vec.assign(std::istream_iterator<int>{in}, std::istream_iterator<int>{});
+	AssertAllEqual(vec, { 4, 5, 6 });
+}
+
 TEST(Vector, Erase) {
 	ostl::vector<int> c{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
 	AssertAllEqual(c, { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
@@ -169,6 +229,47 @@ TEST(Vector, Modifiers) {
 	AssertAllEqual(numbers, { "wtf"s, "x35"s });
 }
 
+TEST(Vector, PushBack) {
+	ostl::vector<std::string> strs;
+	strs.push_back("self");
+	for (auto i = 0; i < 5; ++i)
+		strs.push_back(strs.front());
+	AssertAllEqual<std::string>(strs, "self");
+
+	ostl::vector<int> ints;
+	ints.reserve(3);
+	const auto cap = ints.capacity();
+	ints.push_back_unchecked(1);
+	ints.emplace_back_unchecked(2);
+	ints.push_back_unchecked(ints[0]);
+	AssertAllEqual(ints, { 1, 2, 1 });
+	ASSERT_EQ(ints.capacity(), cap);
+}
+
+TEST(Vector, ResizeForOverwrite) {
+	ostl::vector<char> buf{ 'a', 'b' };
+	buf.resize_for_overwrite(5);
+	ASSERT_EQ(buf.size(), 5);
+	ASSERT_EQ(buf[1], 'b');
+	std::memcpy(buf.data() + 2, "cde", 3);
+
+	char* tail = buf.append_uninitialized(3);
+	ASSERT_EQ(tail, buf.data() + 5);
+	std::memcpy(tail, "fgh", 3);
+	AssertAllEqual(buf, { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' });
+
+	buf.resize_for_overwrite(1);
+	AssertAllEqual(buf, { 'a' });
+
+	ostl::vector<std::string> strs;
+	strs.resize_for_overwrite(3);
+	AssertAllEqual<std::string>(strs, "");
+
+	ostl::vector<int> ints{ 1 };
+	ints.resize(3);
+	AssertAllEqual(ints, { 1, 0, 0 });
+}
+
 TEST(Vector, Compare) {
 	const ostl::vector<int> vec1{ 6, 9, 7, 4 };
 	const ostl::vector<int> vec2{ 6, 9, 7, 4 };
@@ -182,8 +283,35 @@ TEST(Vector, Compare) {
 	ASSERT_TRUE(vec1 >= vec3);
 }
 
+// Plain std::allocator behaviour, without the malloc usable-size slack
+template <class T>
+struct ExactAllocator : std::allocator<T>
+{
+	ExactAllocator() = default;
+	template <class U> ExactAllocator(const ExactAllocator<U>&) noexcept {}
+};
+
+template <class T>
+struct RoundingAllocator : std::allocator<T>
+{
+	struct result
+	{
+		T* ptr;
+		size_t count;
+	};
+
+	RoundingAllocator() = default;
+	template <class U> RoundingAllocator(const RoundingAllocator<U>&) noexcept {}
+
+	result allocate_at_least(size_t n)
+	{
+		n = (n + 15) / 16 * 16;
+		return { this->allocate(n), n };
+	}
+};
+
 TEST(Vector, CapacityGrowth) {
-	ostl::vector<int> v;
+	ostl::vector<int, ExactAllocator<int>> v;
 	auto f = [&v](size_t i) {while (i--)v.emplace_back(); };
 	EXPECT_EQ(v.capacity(), 0);
 	f(1);
@@ -210,6 +338,134 @@ TEST(Vector, CapacityGrowth) {
 	EXPECT_EQ(v.capacity(), 63);
 }
 
+TEST(Vector, GrowthPolicy) {
+	ostl::vector<int, ExactAllocator<int>, ostl::growth::doubling> v;
+	for (auto i = 0; i < 5; ++i)
+		v.push_back(i);
+	EXPECT_EQ(v.capacity(), 8);
+
+	using ostl::growth::power_of_two;
+	EXPECT_EQ(power_of_two::next_capacity(0, 1, 4), 1);
+	EXPECT_EQ(power_of_two::next_capacity(3, 4, 4), 8);
+	EXPECT_EQ(power_of_two::next_capacity(10, 11, 12), 21);
+
+	using capped = ostl::growth::capped_linear<1024>;
+	EXPECT_EQ(capped::next_capacity(0, 1, 8), 1);
+	EXPECT_EQ(capped::next_capacity(100, 101, 8), 150);
+	EXPECT_EQ(capped::next_capacity(1000, 1001, 8), 1128);
+	EXPECT_EQ(capped::next_capacity(1000, 5000, 8), 5000);
+
+	ostl::vector<bool, std::allocator<bool>, ostl::growth::doubling> bits;
+	for (auto i = 0; i < 200; ++i)
+		bits.push_back(i % 3 == 0);
+	ASSERT_EQ(bits.size(), 200);
+	for (auto i = 0; i < 200; ++i)
+		ASSERT_EQ(bits[i], i % 3 == 0);
+}
+
+TEST(Vector, AllocateAtLeast) {
+	ostl::vector<int, RoundingAllocator<int>> v;
+	v.push_back(1);
+	EXPECT_EQ(v.capacity(), 16);
+	for (auto i = 0; i < 16; ++i)
+		v.push_back(i);
+	EXPECT_EQ(v.capacity(), 32);
+
+	v.reserve(33);
+	EXPECT_EQ(v.capacity(), 48);
+
+	ostl::vector<bool, RoundingAllocator<bool>> bits(1, true);
+	EXPECT_EQ(bits.capacity(), 16 * 8 * sizeof(size_t));
+
+	ostl::vector<char> chars;
+	chars.push_back('a');
+	EXPECT_GE(chars.capacity(), 1);
+}
+
+TEST(Vector, InPlaceGrowth) {
+	ostl::vector<int, ostl::malloc_allocator<int>, ostl::growth::in_place<>> v;
+	for (auto i = 0; i < 100000; ++i)
+		v.push_back(i);
+	v.push_back(v[5]);
+	v.insert(v.begin() + 1, 1000, -1);
+	v.erase(v.begin() + 1, v.begin() + 1001);
+	v.shrink_to_fit();
+
+	ASSERT_EQ(v.size(), 100001);
+	for (auto i = 0; i < 100000; ++i)
+		ASSERT_EQ(v[i], i);
+	ASSERT_EQ(v.back(), 5);
+
+	ostl::vector<std::string, ostl::malloc_allocator<std::string>, ostl::growth::in_place<>> strs{ "a", "b" };
+	strs.push_back(strs[0]);
+	ASSERT_EQ(strs.size(), 3);
+	ASSERT_EQ(strs[2], "a");
+
+	// malloc's usable size shows up as capacity; std::allocator stays exact
+	ostl::vector<char, ostl::malloc_allocator<char>> chars{ 'a' };
+	ostl::vector<char> exact{ 'a' };
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+	EXPECT_GT(chars.capacity(), 1);
+#endif
+	EXPECT_EQ(exact.capacity(), 1);
+}
+
+struct Relocatable
+{
+	explicit Relocatable(int v) : p{std::make_unique<int>(v)} {}
+	std::unique_ptr<int> p;
+};
+
+template <>
+struct ostl::is_trivially_relocatable<Relocatable> : std::true_type {};
+
+TEST(Vector, Relocation) {
+	static_assert(ostl::is_trivially_relocatable_v<int>);
+	static_assert(!ostl::is_trivially_relocatable_v<std::string>);
+	static_assert(ostl::is_trivially_relocatable_v<Relocatable>);
+
+	ostl::vector<Relocatable> v;
+	for (auto i = 0; i < 10; ++i)
+		v.emplace_back(i);
+	v.emplace(v.begin() + 3, 42);
+	v.erase(v.begin());
+	v.reserve(100);
+	v.shrink_to_fit();
+
+	ASSERT_EQ(v.size(), 10);
+	ASSERT_GE(v.capacity(), 10);
+	ASSERT_LT(v.capacity(), 100);
+	const auto expected = { 1, 2, 42, 3, 4, 5, 6, 7, 8, 9 };
+	auto it = v.begin();
+	for (const auto e : expected)
+		ASSERT_EQ(*(it++)->p, e);
+}
+
+TEST(Vector, BulkCopy) {
+	const ostl::vector<float> filled(1000, 1.5f);
+	AssertAllEqual(filled, 1.5f);
+
+	ostl::vector<int> src;
+	for (auto i = 0; i < 1000; ++i)
+		src.push_back(i);
+
+	const auto copy = src;
+	ASSERT_TRUE(copy == src);
+
+	ostl::vector<int> assigned{ 1, 2, 3 };
+	assigned = src;
+	ASSERT_TRUE(assigned == src);
+
+	assigned.assign(500, 7);
+	ASSERT_EQ(assigned.size(), 500);
+	AssertAllEqual(assigned, 7);
+
+	assigned.insert(assigned.begin() + 1, 3, 9);
+	assigned.insert(assigned.begin(), { 1, 2 });
+	ASSERT_EQ(assigned.size(), 505);
+	AssertAllEqual(ostl::vector<int>(assigned.begin(), assigned.begin() + 6), { 1, 2, 7, 9, 9, 9 });
+}
+
 TEST(VectorBool, Constructor) {
 	const auto init = { false, true, true, false, true };
 	ostl::vector words1(init);
@@ -359,4 +615,222 @@ TEST(VectorBool, Compare) {
 	ASSERT_TRUE(vec1 <= vec2);
 	ASSERT_FALSE(vec1 > vec2);
 	ASSERT_TRUE(vec1 >= vec3);
-}
\ No newline at end of file
+}
+TEST(SmallVector, Inline) {
+	static_assert(std::is_same_v<ostl::small_vector<int, 8>::iterator, ostl::vector<int>::iterator>);
+
+	ostl::small_vector<int, 8> v;
+	const auto is_inline = [&]
+	{
+		const auto d = reinterpret_cast<const char*>(v.data()) - reinterpret_cast<const char*>(&v);
+		return d >= 0 && d < ptrdiff_t(sizeof v);
+	};
+
+	for (auto i = 0; i < 8; ++i)
+		v.push_back(i);
+	ASSERT_TRUE(is_inline());
+	ASSERT_EQ(v.capacity(), 8);
+
+	v.insert(v.begin(), 2, -1);
+	ASSERT_FALSE(is_inline());
+	AssertAllEqual(ostl::vector<int>(v.begin(), v.end()), { -1, -1, 0, 1, 2, 3, 4, 5, 6, 7 });
+
+	v.erase(v.begin(), v.begin() + 5);
+	v.shrink_to_fit();
+	ASSERT_TRUE(is_inline());
+	AssertAllEqual(ostl::vector<int>(v.begin(), v.end()), { 3, 4, 5, 6, 7 });
+}
+
+TEST(SmallVector, CopyMove) {
+	using vec = ostl::small_vector<std::string, 2>;
+
+	vec small{ "a", "b" };
+	vec big{ "c", "d", "e" };
+
+	vec small2 = small;
+	vec small3 = std::move(small);
+	ASSERT_TRUE(small.empty());
+	ASSERT_TRUE(small2 == small3);
+	ASSERT_EQ(small3[1], "b");
+
+	vec big2 = std::move(big);
+	ASSERT_TRUE(big.empty());
+	ASSERT_EQ(big2.size(), 3);
+
+	ostl::swap(small3, big2);
+	ASSERT_EQ(small3.size(), 3);
+	ASSERT_EQ(small3[2], "e");
+	ASSERT_EQ(big2.size(), 2);
+	ASSERT_EQ(big2[0], "a");
+
+	big2 = small3;
+	ASSERT_TRUE(big2 == small3);
+	small3 = vec{ "x" };
+	ASSERT_EQ(small3.size(), 1);
+	ASSERT_EQ(small3[0], "x");
+}
+
+TEST(SmallVector, Bool) {
+	ostl::small_vector<bool, 64> bits(10, true);
+	bits.push_back(false);
+	bits.insert(bits.begin(), false);
+	ASSERT_EQ(bits.size(), 12);
+	ASSERT_FALSE(bits.front());
+	ASSERT_FALSE(bits.back());
+	ASSERT_TRUE(bits[5]);
+}
+
+TEST(VectorBool, InsertEraseLarge) {
+	std::mt19937 rng{ 42 };
+	ostl::vector<bool> bits;
+	std::vector<bool> expected;
+
+	for (auto round = 0; round < 300; ++round)
+	{
+		const size_t pos = expected.empty() ? 0 : rng() % (expected.size() + 1);
+		const size_t n = rng() % 4 ? rng() % 200 : 64 * (rng() % 3);
+		if (rng() % 3 && expected.size() < 5000)
+		{
+			const bool x = rng() & 1;
+			bits.insert(bits.begin() + pos, n, x);
+			expected.insert(expected.begin() + pos, n, x);
+		}
+		else
+		{
+			const size_t last = std::min(expected.size(), pos + n);
+			bits.erase(bits.begin() + pos, bits.begin() + last);
+			expected.erase(expected.begin() + pos, expected.begin() + last);
+		}
+
+		ASSERT_EQ(bits.size(), expected.size());
+		ASSERT_TRUE(std::equal(expected.begin(), expected.end(), bits.begin()));
+	}
+}
+
+TEST(VectorBool, BitQueries) {
+	ostl::vector<bool> bits(1000, false);
+	ASSERT_EQ(bits.count(), 0);
+	ASSERT_TRUE(bits.none());
+	ASSERT_FALSE(bits.all());
+	ASSERT_EQ(bits.find_first(), bits.npos);
+	ASSERT_EQ(bits.find_first_unset(), 0);
+
+	const size_t set[] = { 3, 63, 64, 500, 999 };
+	for (const auto i : set)
+		bits[i] = true;
+	ASSERT_EQ(bits.count(), 5);
+	ASSERT_TRUE(bits.any());
+
+	size_t n = 0;
+	for (auto i = bits.find_first(); i != bits.npos; i = bits.find_next(i))
+		ASSERT_EQ(i, set[n++]);
+	ASSERT_EQ(n, 5);
+
+	bits.erase(bits.end() - 1);
+	ASSERT_EQ(bits.count(), 4);
+	ASSERT_EQ(bits.find_next(500), bits.npos);
+	ASSERT_EQ(bits.find_next(bits.npos), bits.npos);
+	ASSERT_EQ(bits.find_next_unset(bits.npos), bits.npos);
+
+	ostl::vector<bool> ones(130, true);
+	ASSERT_TRUE(ones.all());
+	ASSERT_EQ(ones.count(), 130);
+	ASSERT_EQ(ones.find_first_unset(), ones.npos);
+	ones[129] = false;
+	ASSERT_FALSE(ones.all());
+	ASSERT_EQ(ones.find_first_unset(), 129);
+	ASSERT_EQ(ones.find_next_unset(129), ones.npos);
+
+	std::mt19937 rng{ 7 };
+	ostl::vector<bool> random;
+	size_t expected = 0;
+	for (auto i = 0; i < 10000; ++i)
+	{
+		const bool b = rng() % 5 == 0;
+		random.push_back(b);
+		expected += b;
+	}
+	ASSERT_EQ(random.count(), expected);
+}
+
+TEST(VectorBool, SetAlgebra) {
+	std::mt19937 rng{ 3 };
+	const auto random = [&](size_t n)
+	{
+		ostl::vector<bool> v;
+		for (size_t i = 0; i < n; ++i) v.push_back(rng() & 1);
+		return v;
+	};
+	const auto a = random(1000), b = random(1000), c = random(700);
+
+	const ostl::vector<bool> fused = a & b & ~c;
+	ASSERT_EQ(fused.size(), 1000);
+	for (size_t i = 0; i < 1000; ++i)
+		ASSERT_EQ(fused[i], a[i] && b[i] && !(i < 700 && c[i]));
+
+	auto x = a;
+	x |= c;
+	for (size_t i = 0; i < 1000; ++i)
+		ASSERT_EQ(x[i], a[i] || (i < 700 && c[i]));
+
+	x = a;
+	x ^= b;
+	x.and_not(c);
+	for (size_t i = 0; i < 1000; ++i)
+		ASSERT_EQ(x[i], (a[i] != b[i]) && !(i < 700 && c[i]));
+
+	auto y = c;
+	y &= a;
+	ASSERT_EQ(y.size(), 1000);
+	for (size_t i = 0; i < 1000; ++i)
+		ASSERT_EQ(y[i], i < 700 && c[i] && a[i]);
+
+	y = c;
+	y.flip();
+	ASSERT_EQ(y.count(), 700 - c.count());
+
+	y = c;
+	y ^= ~y;
+	ASSERT_TRUE(y.all());
+}
+
+TEST(VectorBool, Fill) {
+	ostl::vector<bool> v(300, true);
+	ASSERT_EQ(v.count(), 300);
+
+	v.insert(v.begin() + 5, 200, false);
+	ASSERT_EQ(v.size(), 500);
+	ASSERT_EQ(v.count(), 300);
+	ASSERT_EQ(v.find_first_unset(), 5);
+	ASSERT_EQ(v.find_next(4), 205);
+
+	v.resize(700);
+	ASSERT_EQ(v.count(), 300);
+	v.resize(1000, true);
+	ASSERT_EQ(v.count(), 600);
+	ASSERT_EQ(v.find_next_unset(699), ostl::vector<bool>::npos);
+
+	v.assign(130, true);
+	ASSERT_EQ(v.size(), 130);
+	ASSERT_TRUE(v.all());
+	v.assign(70, false);
+	ASSERT_TRUE(v.none());
+
+	std::mt19937 rng{ 5 };
+	ostl::vector<bool> src;
+	std::vector<bool> ref;
+	for (auto i = 0; i < 500; ++i)
+	{
+		const bool b = rng() & 1;
+		src.push_back(b);
+		ref.push_back(b);
+	}
+
+	const ostl::vector<bool> sub(src.begin() + 3, src.begin() + 400);
+	ASSERT_TRUE(std::equal(sub.begin(), sub.end(), ref.begin() + 3));
+
+	src.insert(src.begin() + 100, src.begin() + 17, src.begin() + 333);
+	ref.insert(ref.begin() + 100, ref.begin() + 17, ref.begin() + 333);
+	ASSERT_EQ(src.size(), ref.size());
+	ASSERT_TRUE(std::equal(src.begin(), src.end(), ref.begin()));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include "internal/alloc_traits.h"
+
+namespace ostl
+{
+	// Allocates every block on an Align-byte boundary (32 for AVX, 64 for a cache line) and rounds its
+	// size up to a multiple of Align, so no other allocation shares its first or last cache line.
+	// vector reports the extra room as capacity and marks data() as aligned.
+	template <class T, size_t Align = 64>
+	class aligned_allocator
+	{
+		static_assert(Align && (Align & (Align - 1)) == 0, "Align must be a power of two");
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using propagate_on_container_move_assignment = std::true_type;
+		using is_always_equal = std::true_type;
+
+		template <class U>
+		struct rebind
+		{
+			using other = aligned_allocator<U, Align>;
+		};
+
+		static constexpr size_t alignment = std::max(Align, alignof(T));
+
+		aligned_allocator() noexcept = default;
+
+		template <class U>
+		aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+		{
+		}
+
+		[[nodiscard]] T* allocate(const size_t n) { return allocate_at_least(n).ptr; }
+
+		[[nodiscard]] internal::AllocationResult<T*> allocate_at_least(const size_t n)
+		{
+			if (n > (size_t(-1) - alignment) / sizeof(T)) throw std::bad_array_new_length{};
+			const size_t bytes = (n * sizeof(T) + (alignment - 1)) & ~(alignment - 1);
+			return {static_cast<T*>(::operator new(bytes, std::align_val_t{alignment})), bytes / sizeof(T)};
+		}
+
+		void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t{alignment}); }
+
+		[[nodiscard]] friend bool operator==(const aligned_allocator&, const aligned_allocator&) noexcept { return true; }
+		[[nodiscard]] friend bool operator!=(const aligned_allocator&, const aligned_allocator&) noexcept { return false; }
+	};
+}
@@ -0,0 +1,554 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include "internal/config.h"
+#include "internal/iterator.h"
+
+namespace ostl
+{
+	// A vector that any number of threads can append to and read from at once. Elements live in segments
+	// that double in size and are never moved, so references stay valid while others append. Appending
+	// reserves indices with one fetch_add and allocates missing segments with a compare-and-swap; an element
+	// counts towards size() once it and every element before it are constructed, so all of [0, size()) can
+	// be read while other threads keep appending. The allocator must be usable from several threads.
+	//
+	// Everything except clear, assignment, swap and destruction may run concurrently. If an element's
+	// constructor throws, its slot and the rest of its grow_by range are skipped: size() still passes them,
+	// but they hold no element and must not be read. If allocating a segment throws, elements after it are
+	// never published.
+	template <class T, class Alloc = std::allocator<T>>
+	class concurrent_vector
+	{
+		using alloc_traits = std::allocator_traits<Alloc>;
+		using flag_type = std::atomic<uint8_t>;
+		using flag_alloc = typename alloc_traits::template rebind_alloc<flag_type>;
+
+		enum : uint8_t { empty_slot, constructed_slot, failed_slot };
+
+	public:
+		using value_type = T;
+		using allocator_type = Alloc;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+
+		static constexpr size_type first_segment = std::bit_floor(std::max<size_t>(8, 512 / sizeof(T)));
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			const_iterator() = default;
+
+			const_iterator(const concurrent_vector* v, const size_type idx) : v_{v}, idx_{idx}
+			{
+			}
+
+			[[nodiscard]] reference operator*() const { return (*v_)[idx_]; }
+			[[nodiscard]] reference operator[](const difference_type n) const { return (*v_)[idx_ + n]; }
+			[[nodiscard]] pointer operator->() const { return &**this; }
+
+			const_iterator& operator++() { return *this += 1; }
+
+			const_iterator operator++(int)
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			const_iterator& operator--() { return *this -= 1; }
+
+			const_iterator operator--(int)
+			{
+				const auto it = *this;
+				--*this;
+				return it;
+			}
+
+			const_iterator& operator+=(const difference_type n)
+			{
+				idx_ += n;
+				return *this;
+			}
+
+			[[nodiscard]] const_iterator operator+(const difference_type n) const
+			{
+				const_iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			const_iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] const_iterator operator-(const difference_type n) const { return *this + -n; }
+
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const
+			{
+				return static_cast<difference_type>(idx_ - rhs.idx_);
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const { return idx_ == rhs.idx_; }
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+			[[nodiscard]] bool operator<(const const_iterator& rhs) const { return idx_ < rhs.idx_; }
+			[[nodiscard]] bool operator>(const const_iterator& rhs) const { return rhs < *this; }
+			[[nodiscard]] bool operator>=(const const_iterator& rhs) const { return !(*this < rhs); }
+			[[nodiscard]] bool operator<=(const const_iterator& rhs) const { return !(*this > rhs); }
+
+		protected:
+			friend concurrent_vector;
+
+			const concurrent_vector* v_ = nullptr;
+			size_type idx_ = 0;
+		};
+
+		class iterator : public const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
+
+			iterator() = default;
+
+			iterator(concurrent_vector* v, const size_type idx) : const_iterator{v, idx}
+			{
+			}
+
+			[[nodiscard]] reference operator*() const { return const_cast<reference>(const_iterator::operator*()); }
+			[[nodiscard]] reference operator[](const difference_type n) const { return *(*this + n); }
+			[[nodiscard]] pointer operator->() const { return &**this; }
+
+			iterator& operator++() { return *this += 1; }
+
+			iterator operator++(int)
+			{
+				iterator it = *this;
+				++*this;
+				return it;
+			}
+
+			iterator& operator--() { return *this -= 1; }
+
+			iterator operator--(int)
+			{
+				iterator it = *this;
+				--*this;
+				return it;
+			}
+
+			iterator& operator+=(const difference_type n)
+			{
+				const_iterator::operator+=(n);
+				return *this;
+			}
+
+			[[nodiscard]] iterator operator+(const difference_type n) const
+			{
+				iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] iterator operator-(const difference_type n) const { return *this + -n; }
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const { return const_iterator::operator-(rhs); }
+		};
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		concurrent_vector() = default;
+
+		explicit concurrent_vector(const Alloc& alloc) noexcept : alloc_{alloc}
+		{
+		}
+
+		concurrent_vector(const std::initializer_list<T> init, const Alloc& alloc = Alloc{}) : concurrent_vector{alloc}
+		{
+			grow_by(init.begin(), init.end());
+		}
+
+		concurrent_vector(const concurrent_vector& x)
+			: concurrent_vector{alloc_traits::select_on_container_copy_construction(x.alloc_)}
+		{
+			append_from(x);
+		}
+
+		concurrent_vector(concurrent_vector&& x) noexcept : concurrent_vector{x.alloc_}
+		{
+			swap(x);
+		}
+
+		concurrent_vector& operator=(const concurrent_vector& x)
+		{
+			if (this == &x) return *this;
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+			{
+				// Segments must go back to the allocator that made them
+				if (alloc_ != x.alloc_) release();
+				alloc_ = x.alloc_;
+			}
+			clear();
+			append_from(x);
+			return *this;
+		}
+
+		concurrent_vector& operator=(concurrent_vector&& x)
+		noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+		{
+			if (this == &x) return *this;
+			if constexpr (!alloc_traits::propagate_on_container_move_assignment::value && !alloc_traits::is_always_equal::value)
+			{
+				if (alloc_ != x.alloc_)
+				{
+					clear();
+					append_from(x);
+					return *this;
+				}
+			}
+
+			release();
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) alloc_ = std::move(x.alloc_);
+			for (size_type s = 0; s < max_segments; ++s)
+			{
+				segments_[s].store(x.segments_[s].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+				flags_[s].store(x.flags_[s].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+			reserved_.store(x.reserved_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+			published_.store(x.published_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+			return *this;
+		}
+
+		~concurrent_vector()
+		{
+			release();
+		}
+
+		[[nodiscard]] allocator_type get_allocator() const noexcept { return alloc_; }
+
+		iterator push_back(const T& value) { return emplace_back(value); }
+		iterator push_back(T&& value) { return emplace_back(std::move(value)); }
+
+		template <class... Args>
+		iterator emplace_back(Args&&... args)
+		{
+			const size_type i = reserved_.fetch_add(1, std::memory_order_relaxed);
+			construct(i, std::forward<Args>(args)...);
+			return {this, i};
+		}
+
+		// Appends n value-initialized elements, returning an iterator to the first
+		iterator grow_by(const size_type n)
+		{
+			const size_type first = reserved_.fetch_add(n, std::memory_order_relaxed);
+			construct_range(first, first + n, [&](const size_type i) { construct(i); });
+			return {this, first};
+		}
+
+		iterator grow_by(const size_type n, const T& value)
+		{
+			const size_type first = reserved_.fetch_add(n, std::memory_order_relaxed);
+			construct_range(first, first + n, [&](const size_type i) { construct(i, value); });
+			return {this, first};
+		}
+
+		template <class ForwardIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>>>
+		iterator grow_by(ForwardIt first, const ForwardIt last)
+		{
+			const auto n = static_cast<size_type>(std::distance(first, last));
+			const size_type start = reserved_.fetch_add(n, std::memory_order_relaxed);
+			construct_range(start, start + n, [&](const size_type i)
+			{
+				construct(i, *first);
+				++first;
+			});
+			return {this, start};
+		}
+
+		iterator grow_by(const std::initializer_list<T> init) { return grow_by(init.begin(), init.end()); }
+
+		// Allocates the segments for the first n elements up front
+		void reserve(const size_type n)
+		{
+			if (n > max_size()) throw std::length_error{""};
+			if (n == 0) return;
+			const size_type last = Locate(n - 1).segment;
+			for (size_type s = 0; s <= last; ++s) (void)segment(s);
+		}
+
+		// Not thread-safe. Keeps the segments.
+		void clear() noexcept
+		{
+			const size_type n = reserved_.load(std::memory_order_relaxed);
+			for (size_type s = 0; s < max_segments && SegmentStart(s) < n; ++s)
+			{
+				const auto f = flags_[s].load(std::memory_order_relaxed);
+				if (!f) continue;
+				const auto p = segments_[s].load(std::memory_order_relaxed);
+				const size_type len = std::min(SegmentSize(s), n - SegmentStart(s));
+				for (size_type i = 0; i < len; ++i)
+				{
+					if (f[i].load(std::memory_order_relaxed) == constructed_slot) alloc_traits::destroy(alloc_, std::addressof(p[i]));
+					f[i].store(empty_slot, std::memory_order_relaxed);
+				}
+			}
+			reserved_.store(0, std::memory_order_relaxed);
+			published_.store(0, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] reference at(size_type n)
+		{
+			return const_cast<reference>(static_cast<const concurrent_vector&>(*this).at(n));
+		}
+
+		[[nodiscard]] const_reference at(size_type n) const
+		{
+			if (n >= size()) throw std::out_of_range{""};
+			return (*this)[n];
+		}
+
+		[[nodiscard]] reference operator[](size_type n)
+		{
+			return const_cast<reference>(static_cast<const concurrent_vector&>(*this)[n]);
+		}
+
+		[[nodiscard]] const_reference operator[](size_type n) const
+		{
+			const auto [s, i] = Locate(n);
+			return segments_[s].load(std::memory_order_acquire)[i];
+		}
+
+		[[nodiscard]] reference front() { return (*this)[0]; }
+		[[nodiscard]] const_reference front() const { return (*this)[0]; }
+		[[nodiscard]] reference back() { return (*this)[size() - 1]; }
+		[[nodiscard]] const_reference back() const { return (*this)[size() - 1]; }
+
+		[[nodiscard]] iterator begin() noexcept { return {this, 0}; }
+		[[nodiscard]] const_iterator begin() const noexcept { return {this, 0}; }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+
+		// Ends at the size() seen when called
+		[[nodiscard]] iterator end() noexcept { return {this, size()}; }
+		[[nodiscard]] const_iterator end() const noexcept { return {this, size()}; }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{cend()}; }
+
+		[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return const_reverse_iterator{cbegin()}; }
+
+		[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+		// Number of published elements: all of them are constructed and visible to the caller
+		[[nodiscard]] size_type size() const noexcept { return published_.load(std::memory_order_acquire); }
+
+		[[nodiscard]] static size_type max_size() noexcept { return std::numeric_limits<difference_type>::max() / sizeof(T); }
+
+		// Elements that fit before the first unallocated segment
+		[[nodiscard]] size_type capacity() const noexcept
+		{
+			size_type s = 0;
+			while (s < max_segments && segments_[s].load(std::memory_order_acquire)) ++s;
+			return SegmentStart(s);
+		}
+
+		// Not thread-safe
+		void swap(concurrent_vector& x) noexcept
+		{
+			if constexpr (alloc_traits::propagate_on_container_swap::value)
+			{
+				using std::swap;
+				swap(alloc_, x.alloc_);
+			}
+
+			for (size_type s = 0; s < max_segments; ++s)
+			{
+				segments_[s].store(x.segments_[s].exchange(segments_[s].load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+				flags_[s].store(x.flags_[s].exchange(flags_[s].load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+			reserved_.store(x.reserved_.exchange(reserved_.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+			published_.store(x.published_.exchange(published_.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr size_type segment_shift = std::countr_zero(first_segment);
+		static constexpr size_type max_segments = 64 - segment_shift;
+
+		struct Location
+		{
+			size_type segment;
+			size_type offset;
+		};
+
+		// Segment s holds first_segment << s elements starting at first_segment * (2^s - 1)
+		[[nodiscard]] static constexpr size_type SegmentSize(const size_type s) noexcept { return first_segment << s; }
+		[[nodiscard]] static constexpr size_type SegmentStart(const size_type s) noexcept { return ((size_type{1} << s) - 1) << segment_shift; }
+
+		[[nodiscard]] static constexpr Location Locate(const size_type i) noexcept
+		{
+			const auto s = static_cast<size_type>(std::bit_width((i >> segment_shift) + 1) - 1);
+			return {s, i - SegmentStart(s)};
+		}
+
+		[[nodiscard]] T* segment(const size_type s)
+		{
+			if (const auto p = segments_[s].load(std::memory_order_acquire)) return p;
+			return allocate_segment(s);
+		}
+
+		// Whoever loses the race to install a segment frees its own allocation and uses the winner's
+		OSTL_NOINLINE T* allocate_segment(const size_type s)
+		{
+			const size_type n = SegmentSize(s);
+			if (!flags_[s].load(std::memory_order_acquire))
+			{
+				flag_alloc fa{alloc_};
+				const auto f = std::allocator_traits<flag_alloc>::allocate(fa, n);
+				for (size_type i = 0; i < n; ++i) ::new(static_cast<void*>(f + i)) flag_type{empty_slot};
+				flag_type* expected = nullptr;
+				if (!flags_[s].compare_exchange_strong(expected, f, std::memory_order_acq_rel))
+					std::allocator_traits<flag_alloc>::deallocate(fa, f, n);
+			}
+
+			T* p = alloc_traits::allocate(alloc_, n);
+			T* expected = nullptr;
+			if (segments_[s].compare_exchange_strong(expected, p, std::memory_order_acq_rel)) return p;
+			alloc_traits::deallocate(alloc_, p, n);
+			return expected;
+		}
+
+		template <class... Args>
+		void construct(const size_type i, Args&&... args)
+		{
+			const auto [s, off] = Locate(i);
+			T* const p = segment(s) + off;
+			try
+			{
+				alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				publish(i, failed_slot);
+				throw;
+			}
+			publish(i, constructed_slot);
+		}
+
+		// Calls construct_at for each slot in [first, last). Once one throws, the slots after it are marked
+		// failed as well, since nothing else would ever publish them and size() would stop there for good.
+		template <class F>
+		void construct_range(const size_type first, const size_type last, F construct_at)
+		{
+			if (first == last) return;
+			for (size_type s = Locate(first).segment; s <= Locate(last - 1).segment; ++s) (void)segment(s);
+
+			size_type i = first;
+			try
+			{
+				for (; i < last; ++i) construct_at(i);
+			}
+			catch (...)
+			{
+				while (++i < last) publish(i, failed_slot);
+				throw;
+			}
+		}
+
+		[[nodiscard]] bool ready(const size_type i) const noexcept
+		{
+			const auto [s, off] = Locate(i);
+			const auto f = flags_[s].load();
+			return f && f[off].load() != empty_slot;
+		}
+
+		// Marks slot i done, then advances published_ over every done slot that follows it. The flag store
+		// and the loads below are sequentially consistent, so when two threads finish neighbouring slots at
+		// once, at least one of them sees the other's flag and carries published_ past both.
+		void publish(const size_type i, const uint8_t state) noexcept
+		{
+			const auto [s, off] = Locate(i);
+			flags_[s].load()[off].store(state);
+
+			size_type p = published_.load();
+			while (ready(p))
+				if (published_.compare_exchange_weak(p, p + 1)) ++p;
+		}
+
+		// Appends x's elements, skipping its failed slots, and moves them out unless V is const
+		template <class V>
+		void append_from(V& x)
+		{
+			const size_type n = x.size();
+			reserve(n);
+			for (size_type i = 0; i < n; ++i)
+			{
+				const auto [s, off] = Locate(i);
+				if (x.flags_[s].load(std::memory_order_relaxed)[off].load(std::memory_order_relaxed) != constructed_slot) continue;
+				if constexpr (std::is_const_v<V>) push_back(x[i]);
+				else push_back(std::move(x[i]));
+			}
+		}
+
+		// Destroys the elements and frees every segment
+		void release() noexcept
+		{
+			clear();
+			for (size_type s = 0; s < max_segments; ++s)
+			{
+				const size_type n = SegmentSize(s);
+				if (const auto p = segments_[s].exchange(nullptr, std::memory_order_relaxed)) alloc_traits::deallocate(alloc_, p, n);
+				if (const auto f = flags_[s].exchange(nullptr, std::memory_order_relaxed))
+				{
+					flag_alloc fa{alloc_};
+					std::allocator_traits<flag_alloc>::deallocate(fa, f, n);
+				}
+			}
+		}
+
+		[[no_unique_address]] Alloc alloc_;
+		std::atomic<T*> segments_[max_segments] = {};
+		std::atomic<flag_type*> flags_[max_segments] = {};
+		alignas(64) std::atomic<size_type> reserved_ = 0;
+		alignas(64) std::atomic<size_type> published_ = 0;
+	};
+
+	template <class T, class Alloc>
+	[[nodiscard]] bool operator==(const concurrent_vector<T, Alloc>& lhs, const concurrent_vector<T, Alloc>& rhs)
+	{
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class T, class Alloc>
+	[[nodiscard]] bool operator!=(const concurrent_vector<T, Alloc>& lhs, const concurrent_vector<T, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class T, class Alloc>
+	void swap(concurrent_vector<T, Alloc>& lhs, concurrent_vector<T, Alloc>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,795 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include "vector.h"
+
+namespace ostl
+{
+	// Elements per deque block. Specialize to tune a type's blocks for cache behavior; the default aims at 4 KiB.
+	template <class T>
+	struct deque_block_size : std::integral_constant<size_t, std::bit_floor(std::max<size_t>(16, 4096 / sizeof(T)))>
+	{
+	};
+
+	// A double-ended queue made of fixed-size blocks listed in a map. Both ends grow and shrink in O(1)
+	// without moving elements, so references stay valid across push/pop at either end (iterators do not,
+	// as the map may be rebuilt). Emptied blocks are kept as spares until shrink_to_fit; when one end runs
+	// out of map, the map is rotated to reuse the other end's slots, or doubled. The map is an ostl::vector
+	// of block pointers, and inserting or erasing in the middle relocates the shorter side with memmove
+	// when T is trivially relocatable, as vector does.
+	template <class T, class Alloc = std::allocator<T>, size_t BlockSize = deque_block_size<T>::value>
+	class deque
+	{
+		static_assert(BlockSize > 0);
+
+		using alloc_traits = std::allocator_traits<Alloc>;
+
+	public:
+		using value_type = T;
+		using allocator_type = Alloc;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = typename alloc_traits::pointer;
+		using const_pointer = typename alloc_traits::const_pointer;
+
+		static constexpr size_type block_size = BlockSize;
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = ptrdiff_t;
+			using pointer = const T*;
+			using reference = const T&;
+
+			const_iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return (*node_)[off_]; }
+			[[nodiscard]] reference operator[](const difference_type n) const { return *(*this + n); }
+			[[nodiscard]] pointer operator->() const { return std::addressof(**this); }
+
+			const_iterator& operator++()
+			{
+				if (++off_ == BlockSize)
+				{
+					++node_;
+					off_ = 0;
+				}
+				return *this;
+			}
+
+			const_iterator operator++(int)
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			const_iterator& operator--()
+			{
+				if (off_ == 0)
+				{
+					--node_;
+					off_ = BlockSize;
+				}
+				--off_;
+				return *this;
+			}
+
+			const_iterator operator--(int)
+			{
+				const auto it = *this;
+				--*this;
+				return it;
+			}
+
+			const_iterator& operator+=(const difference_type n)
+			{
+				const difference_type pos = static_cast<difference_type>(off_) + n;
+				const difference_type node = FloorDiv(pos);
+				node_ += node;
+				off_ = static_cast<size_type>(pos - node * static_cast<difference_type>(BlockSize));
+				return *this;
+			}
+
+			[[nodiscard]] const_iterator operator+(const difference_type n) const
+			{
+				const_iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			const_iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] const_iterator operator-(const difference_type n) const { return *this + -n; }
+
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const
+			{
+				return (node_ - rhs.node_) * static_cast<difference_type>(BlockSize)
+					+ static_cast<difference_type>(off_) - static_cast<difference_type>(rhs.off_);
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const { return node_ == rhs.node_ && off_ == rhs.off_; }
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+			[[nodiscard]] bool operator<(const const_iterator& rhs) const { return node_ < rhs.node_ || (node_ == rhs.node_ && off_ < rhs.off_); }
+			[[nodiscard]] bool operator>(const const_iterator& rhs) const { return rhs < *this; }
+			[[nodiscard]] bool operator>=(const const_iterator& rhs) const { return !(*this < rhs); }
+			[[nodiscard]] bool operator<=(const const_iterator& rhs) const { return !(*this > rhs); }
+
+		protected:
+			friend deque;
+
+			const_iterator(typename deque::pointer* node, const size_type off) : node_{node}, off_{off}
+			{
+			}
+
+			typename deque::pointer* node_ = nullptr;
+			size_type off_ = 0;
+		};
+
+		class iterator : public const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
+
+			iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return (*this->node_)[this->off_]; }
+			[[nodiscard]] reference operator[](const difference_type n) const { return *(*this + n); }
+			[[nodiscard]] pointer operator->() const { return std::addressof(**this); }
+
+			iterator& operator++()
+			{
+				const_iterator::operator++();
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				iterator it = *this;
+				++*this;
+				return it;
+			}
+
+			iterator& operator--()
+			{
+				const_iterator::operator--();
+				return *this;
+			}
+
+			iterator operator--(int)
+			{
+				iterator it = *this;
+				--*this;
+				return it;
+			}
+
+			iterator& operator+=(const difference_type n)
+			{
+				const_iterator::operator+=(n);
+				return *this;
+			}
+
+			[[nodiscard]] iterator operator+(const difference_type n) const
+			{
+				iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] iterator operator-(const difference_type n) const { return *this + -n; }
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const { return const_iterator::operator-(rhs); }
+
+		private:
+			friend deque;
+
+			iterator(typename deque::pointer* node, const size_type off) : const_iterator{node, off}
+			{
+			}
+		};
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		deque() = default;
+
+		explicit deque(const Alloc& alloc) noexcept : map_{map_alloc{alloc}}, alloc_{alloc}
+		{
+		}
+
+		deque(const size_type n, const T& value, const Alloc& alloc = Alloc{}) : deque{alloc}
+		{
+			insert(cend(), n, value);
+		}
+
+		explicit deque(const size_type n, const Alloc& alloc = Alloc{}) : deque{alloc}
+		{
+			resize(n);
+		}
+
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+		deque(InputIt first, InputIt last, const Alloc& alloc = Alloc{}) : deque{alloc}
+		{
+			insert(cend(), first, last);
+		}
+
+		deque(const std::initializer_list<T> init, const Alloc& alloc = Alloc{}) : deque{alloc}
+		{
+			insert(cend(), init.begin(), init.end());
+		}
+
+		deque(const deque& x) : deque{alloc_traits::select_on_container_copy_construction(x.alloc_)}
+		{
+			insert(cend(), x.begin(), x.end());
+		}
+
+		deque(const deque& x, const Alloc& alloc) : deque{alloc}
+		{
+			insert(cend(), x.begin(), x.end());
+		}
+
+		deque(deque&& x) noexcept : map_{std::move(x.map_)}, alloc_{std::move(x.alloc_)}, head_{x.head_}, size_{x.size_}
+		{
+			x.head_ = x.size_ = 0;
+		}
+
+		~deque()
+		{
+			clear();
+			release_blocks();
+		}
+
+		deque& operator=(const deque& x)
+		{
+			if (this != &x) assign(x.begin(), x.end());
+			return *this;
+		}
+
+		deque& operator=(deque&& x)
+		noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+		{
+			if (this == &x) return *this;
+			if constexpr (!alloc_traits::propagate_on_container_move_assignment::value && !alloc_traits::is_always_equal::value)
+			{
+				if (alloc_ != x.alloc_)
+				{
+					assign(std::make_move_iterator(x.begin()), std::make_move_iterator(x.end()));
+					return *this;
+				}
+			}
+
+			clear();
+			release_blocks();
+			map_ = std::move(x.map_);
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) alloc_ = std::move(x.alloc_);
+			head_ = x.head_;
+			size_ = x.size_;
+			x.head_ = x.size_ = 0;
+			return *this;
+		}
+
+		deque& operator=(const std::initializer_list<T> init)
+		{
+			assign(init.begin(), init.end());
+			return *this;
+		}
+
+		void assign(const size_type n, const T& value)
+		{
+			clear();
+			insert(cend(), n, value);
+		}
+
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+		void assign(const InputIt first, const InputIt last)
+		{
+			clear();
+			insert(cend(), first, last);
+		}
+
+		void assign(const std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+		[[nodiscard]] allocator_type get_allocator() const noexcept { return alloc_; }
+
+		[[nodiscard]] reference at(size_type n)
+		{
+			return const_cast<reference>(static_cast<const deque&>(*this).at(n));
+		}
+
+		[[nodiscard]] const_reference at(size_type n) const
+		{
+			if (n >= size_) throw std::out_of_range{""};
+			return (*this)[n];
+		}
+
+		[[nodiscard]] reference operator[](size_type n) { return *slot(head_ + n); }
+		[[nodiscard]] const_reference operator[](size_type n) const { return *slot(head_ + n); }
+		[[nodiscard]] reference front() { return *slot(head_); }
+		[[nodiscard]] const_reference front() const { return *slot(head_); }
+		[[nodiscard]] reference back() { return *slot(head_ + size_ - 1); }
+		[[nodiscard]] const_reference back() const { return *slot(head_ + size_ - 1); }
+
+		[[nodiscard]] iterator begin() noexcept { return make_iterator(head_); }
+		[[nodiscard]] const_iterator begin() const noexcept { return make_iterator(head_); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+
+		[[nodiscard]] iterator end() noexcept { return make_iterator(head_ + size_); }
+		[[nodiscard]] const_iterator end() const noexcept { return make_iterator(head_ + size_); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{cend()}; }
+
+		[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return const_reverse_iterator{cbegin()}; }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+		[[nodiscard]] static size_type max_size() noexcept { return std::numeric_limits<difference_type>::max() / sizeof(T); }
+
+		// Frees spare blocks and trims the map to the blocks in use
+		void shrink_to_fit()
+		{
+			if (size_ == 0)
+			{
+				release_blocks();
+				map_.clear();
+				map_.shrink_to_fit();
+				head_ = 0;
+				return;
+			}
+
+			const size_type first = head_ / BlockSize, last = (head_ + size_ - 1) / BlockSize + 1;
+			for (size_type s = 0; s < map_.size(); ++s)
+			{
+				if ((s < first || s >= last) && map_[s])
+				{
+					deallocate_block(map_[s]);
+					map_[s] = nullptr;
+				}
+			}
+			map_.erase(map_.cbegin() + last, map_.cend());
+			map_.erase(map_.cbegin(), map_.cbegin() + first);
+			map_.shrink_to_fit();
+			head_ -= first * BlockSize;
+		}
+
+		// Destroys every element, keeping the blocks for reuse
+		void clear() noexcept
+		{
+			for (size_type i = 0; i < size_; ++i) alloc_traits::destroy(alloc_, slot(head_ + i));
+			size_ = 0;
+			head_ = map_.size() / 2 * BlockSize;
+		}
+
+		iterator insert(const_iterator position, const T& x) { return emplace(position, x); }
+		iterator insert(const_iterator position, T&& x) { return emplace(position, std::move(x)); }
+
+		iterator insert(const_iterator position, const size_type n, const T& x)
+		{
+			const size_type idx = position - cbegin();
+			if (n == 0) return begin() + idx;
+			const T copy(x);
+			const size_type at = open_gap(idx, n);
+			for (size_type i = 0; i < n; ++i) construct_in_gap(at, n, i, copy);
+			size_ += n;
+			return make_iterator(at);
+		}
+
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+		iterator insert(const_iterator position, InputIt first, const InputIt last)
+		{
+			const size_type idx = position - cbegin();
+			if constexpr (internal::IsForwardIterator<InputIt>)
+			{
+				const auto n = static_cast<size_type>(std::distance(first, last));
+				if (n == 0) return begin() + idx;
+				const size_type at = open_gap(idx, n);
+				for (size_type i = 0; i < n; ++i, ++first) construct_in_gap(at, n, i, *first);
+				size_ += n;
+				return make_iterator(at);
+			}
+			else if (idx == size_)
+			{
+				for (; first != last; ++first) emplace_back(*first);
+				return begin() + idx;
+			}
+			else
+			{
+				deque tmp(first, last, alloc_);
+				return insert(position, std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
+			}
+		}
+
+		iterator insert(const_iterator position, const std::initializer_list<T> init)
+		{
+			return insert(position, init.begin(), init.end());
+		}
+
+		template <class R>
+		iterator insert_range(const_iterator position, R&& rg)
+		{
+			return insert(position, std::ranges::begin(rg), std::ranges::end(rg));
+		}
+
+		template <class R>
+		void append_range(R&& rg)
+		{
+			for (auto&& x : rg) emplace_back(std::forward<decltype(x)>(x));
+		}
+
+		template <class R>
+		void prepend_range(R&& rg)
+		{
+			insert_range(cbegin(), std::forward<R>(rg));
+		}
+
+		// Builds the element first, since relocating the neighbours may move what args refer to
+		template <class... Args>
+		iterator emplace(const_iterator position, Args&&... args)
+		{
+			const size_type idx = position - cbegin();
+			if (idx == 0)
+			{
+				emplace_front(std::forward<Args>(args)...);
+				return begin();
+			}
+			if (idx == size_)
+			{
+				emplace_back(std::forward<Args>(args)...);
+				return end() - 1;
+			}
+
+			T x(std::forward<Args>(args)...);
+			const size_type at = open_gap(idx, 1);
+			construct_in_gap(at, 1, 0, std::move(x));
+			++size_;
+			return make_iterator(at);
+		}
+
+		iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+		// Closes the gap from whichever side has fewer elements
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const size_type idx = first - cbegin(), n = last - first;
+			if (n == 0) return begin() + idx;
+
+			for (size_type i = idx; i < idx + n; ++i) alloc_traits::destroy(alloc_, slot(head_ + i));
+			const size_type after = size_ - idx - n;
+			if (idx < after)
+			{
+				relocate(head_, head_ + n, idx);
+				head_ += n;
+			}
+			else
+			{
+				relocate(head_ + idx + n, head_ + idx, after);
+			}
+			size_ -= n;
+			return begin() + idx;
+		}
+
+		void push_back(const T& x) { emplace_back(x); }
+		void push_back(T&& x) { emplace_back(std::move(x)); }
+
+		// Growing the map only moves block pointers, so args may refer to elements
+		template <class... Args>
+		reference emplace_back(Args&&... args)
+		{
+			if (!has_block(head_ + size_)) make_room(0, 1);
+			const pointer p = slot(head_ + size_);
+			alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+			++size_;
+			return *p;
+		}
+
+		void push_front(const T& x) { emplace_front(x); }
+		void push_front(T&& x) { emplace_front(std::move(x)); }
+
+		template <class... Args>
+		reference emplace_front(Args&&... args)
+		{
+			if (head_ == 0 || !has_block(head_ - 1)) make_room(1, 0);
+			const pointer p = slot(head_ - 1);
+			alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+			--head_;
+			++size_;
+			return *p;
+		}
+
+		void pop_back()
+		{
+			alloc_traits::destroy(alloc_, slot(head_ + size_ - 1));
+			--size_;
+		}
+
+		void pop_front()
+		{
+			alloc_traits::destroy(alloc_, slot(head_));
+			++head_;
+			--size_;
+		}
+
+		void resize(const size_type sz)
+		{
+			if (sz > size_)
+			{
+				make_room(0, sz - size_);
+				while (size_ < sz) emplace_back();
+			}
+			else
+			{
+				erase(cbegin() + sz, cend());
+			}
+		}
+
+		void resize(const size_type sz, const T& c)
+		{
+			if (sz > size_) insert(cend(), sz - size_, c);
+			else erase(cbegin() + sz, cend());
+		}
+
+		void swap(deque& x) noexcept
+		{
+			using std::swap;
+			swap(map_, x.map_);
+			if constexpr (alloc_traits::propagate_on_container_swap::value) swap(alloc_, x.alloc_);
+			swap(head_, x.head_);
+			swap(size_, x.size_);
+		}
+
+	private:
+		using map_alloc = typename alloc_traits::template rebind_alloc<pointer>;
+		using map_type = vector<pointer, map_alloc>;
+
+		static constexpr bool relocatable = internal::CanRelocate<T, Alloc>;
+
+		[[nodiscard]] static constexpr difference_type FloorDiv(const difference_type pos) noexcept
+		{
+			constexpr auto b = static_cast<difference_type>(BlockSize);
+			return (pos >= 0 ? pos : pos - (b - 1)) / b;
+		}
+
+		// Positions count elements from the start of the map: element i is at position head_ + i
+		[[nodiscard]] pointer slot(const size_type pos) const noexcept { return map_[pos / BlockSize] + pos % BlockSize; }
+
+		[[nodiscard]] bool has_block(const size_type pos) const noexcept
+		{
+			return pos / BlockSize < map_.size() && map_[pos / BlockSize];
+		}
+
+		[[nodiscard]] iterator make_iterator(const size_type pos) const noexcept
+		{
+			return {const_cast<pointer*>(map_.data()) + pos / BlockSize, pos % BlockSize};
+		}
+
+		// Guarantees allocated blocks for front more positions before the first element and back more after
+		// the last. When the map is short on one side, its slots are rotated so the blocks in use sit in the
+		// middle, after doubling the map if they would take up more than half of it.
+		OSTL_NOINLINE void make_room(const size_type front, const size_type back)
+		{
+			if (front + back > max_size() - size_) throw std::length_error{""};
+
+			constexpr auto b = static_cast<difference_type>(BlockSize);
+			auto lo = static_cast<difference_type>(head_) - static_cast<difference_type>(front);
+			auto hi = static_cast<difference_type>(head_ + size_ + back);
+			difference_type first = FloorDiv(lo), last = FloorDiv(hi + b - 1);
+
+			if (first < 0 || last > static_cast<difference_type>(map_.size()))
+			{
+				const difference_type count = last - first;
+				if (count * 2 > static_cast<difference_type>(map_.size()))
+					map_.resize(std::max<size_type>({8, map_.size() * 2, static_cast<size_type>(count) * 2}), nullptr);
+
+				const auto slots = static_cast<difference_type>(map_.size());
+				const difference_type shift = (slots - count) / 2 - first;
+				const auto m = map_.data();
+				if (shift > 0) std::rotate(m, m + slots - shift, m + slots);
+				else if (shift < 0) std::rotate(m, m - shift, m + slots);
+
+				head_ += shift * b;
+				lo += shift * b;
+				hi += shift * b;
+			}
+
+			// Only the new positions can be missing blocks
+			const auto lo_pos = static_cast<size_type>(lo), hi_pos = static_cast<size_type>(hi);
+			for (size_type s = lo_pos / BlockSize; s * BlockSize < head_; ++s)
+				if (!map_[s]) map_[s] = allocate_block();
+			for (size_type s = (head_ + size_) / BlockSize; s * BlockSize < hi_pos; ++s)
+				if (!map_[s]) map_[s] = allocate_block();
+		}
+
+		// Makes n uninitialized positions at index idx, moving the shorter side, and returns the first position
+		size_type open_gap(const size_type idx, const size_type n)
+		{
+			if (idx < size_ - idx)
+			{
+				make_room(n, 0);
+				relocate(head_, head_ - n, idx);
+				head_ -= n;
+			}
+			else
+			{
+				make_room(0, n);
+				relocate(head_ + idx, head_ + idx + n, size_ - idx);
+			}
+			return head_ + idx;
+		}
+
+		// Constructs the i-th of the n elements of the gap at position at; if that throws, the elements built so
+		// far are destroyed and the gap is closed again
+		template <class... Args>
+		void construct_in_gap(const size_type at, const size_type n, const size_type i, Args&&... args)
+		{
+			try
+			{
+				alloc_traits::construct(alloc_, slot(at + i), std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				for (size_type j = 0; j < i; ++j) alloc_traits::destroy(alloc_, slot(at + j));
+				const size_type idx = at - head_;
+				if (idx < size_ - idx)
+				{
+					relocate(head_, head_ + n, idx);
+					head_ += n;
+				}
+				else
+				{
+					relocate(at + n, at, size_ - idx);
+				}
+				throw;
+			}
+		}
+
+		// Moves count elements from position src to the uninitialized positions at dst, which may overlap
+		void relocate(const size_type src, const size_type dst, size_type count)
+		{
+			if (src == dst || count == 0) return;
+
+			if constexpr (relocatable)
+			{
+				// One memmove per run that stays inside a block on both sides
+				if (dst < src)
+				{
+					for (size_type s = src, d = dst; count;)
+					{
+						const size_type n = std::min({count, BlockSize - s % BlockSize, BlockSize - d % BlockSize});
+						std::memmove(static_cast<void*>(std::to_address(slot(d))), static_cast<const void*>(std::to_address(slot(s))), n * sizeof(T));
+						s += n;
+						d += n;
+						count -= n;
+					}
+				}
+				else
+				{
+					for (size_type s = src + count, d = dst + count; count;)
+					{
+						const size_type n = std::min({count, (s - 1) % BlockSize + 1, (d - 1) % BlockSize + 1});
+						s -= n;
+						d -= n;
+						std::memmove(static_cast<void*>(std::to_address(slot(d))), static_cast<const void*>(std::to_address(slot(s))), n * sizeof(T));
+						count -= n;
+					}
+				}
+			}
+			else if (dst < src)
+			{
+				for (size_type i = 0; i < count; ++i)
+					relocate_one(slot(src + i), slot(dst + i));
+			}
+			else
+			{
+				for (size_type i = count; i--;)
+					relocate_one(slot(src + i), slot(dst + i));
+			}
+		}
+
+		void relocate_one(const pointer src, const pointer dest)
+		{
+			alloc_traits::construct(alloc_, dest, std::move(*src));
+			alloc_traits::destroy(alloc_, src);
+		}
+
+		[[nodiscard]] pointer allocate_block() { return alloc_traits::allocate(alloc_, BlockSize); }
+		void deallocate_block(const pointer p) noexcept { alloc_traits::deallocate(alloc_, p, BlockSize); }
+
+		void release_blocks() noexcept
+		{
+			for (auto& p : map_)
+			{
+				if (p) deallocate_block(p);
+				p = nullptr;
+			}
+		}
+
+		map_type map_;
+		[[no_unique_address]] Alloc alloc_;
+		size_type head_ = 0;
+		size_type size_ = 0;
+	};
+
+	template <class T, class Alloc, size_t B>
+	[[nodiscard]] bool operator==(const deque<T, Alloc, B>& lhs, const deque<T, Alloc, B>& rhs)
+	{
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class T, class Alloc, size_t B>
+	[[nodiscard]] bool operator!=(const deque<T, Alloc, B>& lhs, const deque<T, Alloc, B>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class T, class Alloc, size_t B>
+	[[nodiscard]] bool operator<(const deque<T, Alloc, B>& lhs, const deque<T, Alloc, B>& rhs)
+	{
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class T, class Alloc, size_t B>
+	[[nodiscard]] bool operator<=(const deque<T, Alloc, B>& lhs, const deque<T, Alloc, B>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template <class T, class Alloc, size_t B>
+	[[nodiscard]] bool operator>(const deque<T, Alloc, B>& lhs, const deque<T, Alloc, B>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template <class T, class Alloc, size_t B>
+	[[nodiscard]] bool operator>=(const deque<T, Alloc, B>& lhs, const deque<T, Alloc, B>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template <class T, class Alloc, size_t B>
+	void swap(deque<T, Alloc, B>& lhs, deque<T, Alloc, B>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	template <class T, class Alloc, size_t B, class U>
+	void erase(deque<T, Alloc, B>& c, const U& value)
+	{
+		c.erase(std::remove(c.begin(), c.end(), value), c.end());
+	}
+
+	template <class T, class Alloc, size_t B, class Pred>
+	void erase_if(deque<T, Alloc, B>& c, Pred pred)
+	{
+		c.erase(std::remove_if(c.begin(), c.end(), pred), c.end());
+	}
+
+	template <class InputIt, class Alloc = std::allocator<typename std::iterator_traits<InputIt>::value_type>>
+	deque(InputIt, InputIt, Alloc = Alloc{}) -> deque<typename std::iterator_traits<InputIt>::value_type, Alloc>;
+
+	namespace pmr
+	{
+		template <class T>
+		using deque = ostl::deque<T, std::pmr::polymorphic_allocator<T>>;
+	}
+}
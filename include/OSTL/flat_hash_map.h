@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "functional.h"
+#include "internal/hash_table.h"
+
+namespace ostl
+{
+	// Open-addressing hash map: elements live in one flat slot array next to a control byte per slot, and
+	// lookups test 16 control bytes per SSE2 compare. Erased slots become tombstones only when a probe may
+	// have passed them. Unlike std::unordered_map, rehashing moves elements, so it invalidates references.
+	// With transparent Hash and Eq (the default for std::string keys) lookups take any comparable key, such
+	// as a std::string_view, without building a key_type.
+	template <class K, class V, class Hash = hash<K>, class Eq = equal_to<K>, class Alloc = std::allocator<std::pair<const K, V>>>
+	class flat_hash_map : public internal::HashTable<internal::MapPolicy<K, V>, Hash, Eq, Alloc>
+	{
+		using base = internal::HashTable<internal::MapPolicy<K, V>, Hash, Eq, Alloc>;
+
+		template <class T>
+		static constexpr bool heterogeneous = internal::IsTransparent<Hash> && internal::IsTransparent<Eq>
+			&& !std::is_same_v<std::remove_cvref_t<T>, K>;
+
+	public:
+		using typename base::key_type;
+		using typename base::value_type;
+		using typename base::size_type;
+		using typename base::iterator;
+		using typename base::const_iterator;
+		using mapped_type = V;
+
+		using base::base;
+
+		flat_hash_map() = default;
+
+		template <class InputIt>
+		flat_hash_map(InputIt first, const InputIt last, const size_type bucket_count = 0, const Hash& hash = Hash{},
+		              const Eq& eq = Eq{}, const Alloc& alloc = Alloc{})
+			: base{bucket_count, hash, eq, alloc}
+		{
+			this->insert(first, last);
+		}
+
+		flat_hash_map(const std::initializer_list<value_type> init, const size_type bucket_count = 0,
+		              const Hash& hash = Hash{}, const Eq& eq = Eq{}, const Alloc& alloc = Alloc{})
+			: base{bucket_count, hash, eq, alloc}
+		{
+			this->insert(init);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+		{
+			return try_emplace_impl(key, key, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+		{
+			return try_emplace_impl(key, std::move(key), std::forward<Args>(args)...);
+		}
+
+		// Builds the key from key only when inserting
+		template <class Key, class... Args, class = std::enable_if_t<heterogeneous<Key>>>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+		{
+			return try_emplace_impl(key, key, std::forward<Args>(args)...);
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+		{
+			auto r = this->find(key);
+			if (r != this->end())
+			{
+				r->second = std::forward<M>(obj);
+				return {r, false};
+			}
+			return try_emplace(key, std::forward<M>(obj));
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+		{
+			auto r = this->find(key);
+			if (r != this->end())
+			{
+				r->second = std::forward<M>(obj);
+				return {r, false};
+			}
+			return try_emplace(std::move(key), std::forward<M>(obj));
+		}
+
+		V& operator[](const key_type& key) { return try_emplace(key).first->second; }
+		V& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+		template <class Key, class = std::enable_if_t<heterogeneous<Key>>>
+		V& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+		template <class Key = key_type>
+		[[nodiscard]] V& at(const Key& key)
+		{
+			const auto it = this->find(key);
+			if (it == this->end()) throw std::out_of_range{""};
+			return it->second;
+		}
+
+		template <class Key = key_type>
+		[[nodiscard]] const V& at(const Key& key) const
+		{
+			const auto it = this->find(key);
+			if (it == this->end()) throw std::out_of_range{""};
+			return it->second;
+		}
+
+	private:
+		template <class Key, class KeyArg, class... Args>
+		std::pair<iterator, bool> try_emplace_impl(const Key& key, KeyArg&& key_arg, Args&&... args)
+		{
+			return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(std::forward<KeyArg>(key_arg)),
+			                         std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+	};
+
+	template <class K, class V, class Hash, class Eq, class Alloc, class Pred>
+	size_t erase_if(flat_hash_map<K, V, Hash, Eq, Alloc>& c, Pred pred)
+	{
+		return internal::EraseIf(c, pred);
+	}
+}
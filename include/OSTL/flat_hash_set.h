@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include "functional.h"
+#include "internal/hash_table.h"
+
+namespace ostl
+{
+	// Open-addressing hash set on the same table as flat_hash_map; see there
+	template <class K, class Hash = hash<K>, class Eq = equal_to<K>, class Alloc = std::allocator<K>>
+	class flat_hash_set : public internal::HashTable<internal::SetPolicy<K>, Hash, Eq, Alloc>
+	{
+		using base = internal::HashTable<internal::SetPolicy<K>, Hash, Eq, Alloc>;
+
+	public:
+		using typename base::value_type;
+		using typename base::size_type;
+
+		using base::base;
+
+		flat_hash_set() = default;
+
+		template <class InputIt>
+		flat_hash_set(InputIt first, const InputIt last, const size_type bucket_count = 0, const Hash& hash = Hash{},
+		              const Eq& eq = Eq{}, const Alloc& alloc = Alloc{})
+			: base{bucket_count, hash, eq, alloc}
+		{
+			this->insert(first, last);
+		}
+
+		flat_hash_set(const std::initializer_list<value_type> init, const size_type bucket_count = 0,
+		              const Hash& hash = Hash{}, const Eq& eq = Eq{}, const Alloc& alloc = Alloc{})
+			: base{bucket_count, hash, eq, alloc}
+		{
+			this->insert(init);
+		}
+	};
+
+	template <class K, class Hash, class Eq, class Alloc, class Pred>
+	size_t erase_if(flat_hash_set<K, Hash, Eq, Alloc>& c, Pred pred)
+	{
+		return internal::EraseIf(c, pred);
+	}
+}
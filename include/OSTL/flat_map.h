@@ -0,0 +1,594 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "internal/flat_tree.h"
+#include "vector.h"
+
+namespace ostl
+{
+	// Sorted map over two ostl::vectors, one of keys and one of values, so searches only touch keys.
+	// Iterators yield std::pair<const K&, V&>. A single insert or erase shifts both tails, so build with
+	// insert_range or merge_sorted, which sort the new elements and merge them in once. Search selects the
+	// lookup layout (see ostl::search). With a transparent Compare, lookups take any key comparable with K.
+	template <class K, class V, class Compare = std::less<K>, class Search = search::branchless>
+	class flat_map
+	{
+		template <class Key>
+		using key_arg = std::conditional_t<internal::IsTransparent<Compare>, Key, K>;
+
+		template <class Key>
+		static constexpr bool heterogeneous = internal::IsTransparent<Compare> && !std::is_same_v<std::remove_cvref_t<Key>, K>;
+
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K, V>;
+		using key_compare = Compare;
+		using key_container_type = vector<K>;
+		using mapped_container_type = vector<V>;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = std::pair<const K&, V&>;
+		using const_reference = std::pair<const K&, const V&>;
+
+		class value_compare
+		{
+		public:
+			[[nodiscard]] bool operator()(const const_reference& lhs, const const_reference& rhs) const
+			{
+				return comp_(lhs.first, rhs.first);
+			}
+
+		private:
+			friend flat_map;
+
+			explicit value_compare(const Compare& comp) : comp_{comp}
+			{
+			}
+
+			Compare comp_;
+		};
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename flat_map::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = internal::ArrowProxy<const_reference>;
+			using reference = const_reference;
+
+			const_iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return {keys_[idx_], values_[idx_]}; }
+			[[nodiscard]] pointer operator->() const { return {**this}; }
+			[[nodiscard]] reference operator[](const difference_type n) const { return *(*this + n); }
+
+			const_iterator& operator++() { return *this += 1; }
+
+			const_iterator operator++(int)
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			const_iterator& operator--() { return *this -= 1; }
+
+			const_iterator operator--(int)
+			{
+				const auto it = *this;
+				--*this;
+				return it;
+			}
+
+			const_iterator& operator+=(const difference_type n)
+			{
+				idx_ += n;
+				return *this;
+			}
+
+			[[nodiscard]] const_iterator operator+(const difference_type n) const
+			{
+				const_iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			const_iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] const_iterator operator-(const difference_type n) const { return *this + -n; }
+
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const
+			{
+				return static_cast<difference_type>(idx_ - rhs.idx_);
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const { return idx_ == rhs.idx_; }
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+			[[nodiscard]] bool operator<(const const_iterator& rhs) const { return idx_ < rhs.idx_; }
+			[[nodiscard]] bool operator>(const const_iterator& rhs) const { return rhs < *this; }
+			[[nodiscard]] bool operator>=(const const_iterator& rhs) const { return !(*this < rhs); }
+			[[nodiscard]] bool operator<=(const const_iterator& rhs) const { return !(*this > rhs); }
+
+		protected:
+			friend flat_map;
+
+			const_iterator(K* keys, V* values, const size_type idx) : keys_{keys}, values_{values}, idx_{idx}
+			{
+			}
+
+			K* keys_ = nullptr;
+			V* values_ = nullptr;
+			size_type idx_ = 0;
+		};
+
+		class iterator : public const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename flat_map::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = internal::ArrowProxy<typename flat_map::reference>;
+			using reference = typename flat_map::reference;
+
+			iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return {this->keys_[this->idx_], this->values_[this->idx_]}; }
+			[[nodiscard]] pointer operator->() const { return {**this}; }
+			[[nodiscard]] reference operator[](const difference_type n) const { return *(*this + n); }
+
+			iterator& operator++() { return *this += 1; }
+
+			iterator operator++(int)
+			{
+				iterator it = *this;
+				++*this;
+				return it;
+			}
+
+			iterator& operator--() { return *this -= 1; }
+
+			iterator operator--(int)
+			{
+				iterator it = *this;
+				--*this;
+				return it;
+			}
+
+			iterator& operator+=(const difference_type n)
+			{
+				const_iterator::operator+=(n);
+				return *this;
+			}
+
+			[[nodiscard]] iterator operator+(const difference_type n) const
+			{
+				iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] iterator operator-(const difference_type n) const { return *this + -n; }
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const { return const_iterator::operator-(rhs); }
+
+		private:
+			friend flat_map;
+
+			using const_iterator::const_iterator;
+		};
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		flat_map() = default;
+
+		explicit flat_map(const Compare& comp) : comp_{comp}
+		{
+		}
+
+		template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+		flat_map(InputIt first, const InputIt last, const Compare& comp = Compare{}) : comp_{comp}
+		{
+			insert(first, last);
+		}
+
+		flat_map(const std::initializer_list<value_type> init, const Compare& comp = Compare{})
+			: flat_map{init.begin(), init.end(), comp}
+		{
+		}
+
+		// Takes keys in any order, values[i] belonging to keys[i]
+		flat_map(key_container_type keys, mapped_container_type values, const Compare& comp = Compare{}) : comp_{comp}
+		{
+			if (keys.size() != values.size()) throw std::invalid_argument{""};
+			merge_tail(std::move(keys), std::move(values), false);
+		}
+
+		flat_map& operator=(const std::initializer_list<value_type> init)
+		{
+			clear();
+			insert(init);
+			return *this;
+		}
+
+		[[nodiscard]] iterator begin() noexcept { return {keys_.data(), values_.data(), 0}; }
+		[[nodiscard]] const_iterator begin() const noexcept { return const_cast<flat_map&>(*this).begin(); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] iterator end() noexcept { return {keys_.data(), values_.data(), size()}; }
+		[[nodiscard]] const_iterator end() const noexcept { return const_cast<flat_map&>(*this).end(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+		[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+		[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
+
+		[[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+		[[nodiscard]] size_type size() const noexcept { return keys_.size(); }
+		[[nodiscard]] size_type max_size() const noexcept { return std::min(keys_.max_size(), values_.max_size()); }
+		[[nodiscard]] key_compare key_comp() const { return comp_; }
+		[[nodiscard]] value_compare value_comp() const { return value_compare{comp_}; }
+
+		// The sorted keys, and the values in the same order
+		[[nodiscard]] const key_container_type& keys() const noexcept { return keys_; }
+		[[nodiscard]] const mapped_container_type& values() const noexcept { return values_; }
+
+		// Takes both containers out, leaving the map empty
+		[[nodiscard]] std::pair<key_container_type, mapped_container_type> extract() &&
+		{
+			std::pair<key_container_type, mapped_container_type> c{std::move(keys_), std::move(values_)};
+			clear();
+			return c;
+		}
+
+		// keys must be sorted and unique, values[i] belonging to keys[i]
+		void replace(key_container_type&& keys, mapped_container_type&& values)
+		{
+			if (keys.size() != values.size()) throw std::invalid_argument{""};
+			keys_ = std::move(keys);
+			values_ = std::move(values);
+			index_.rebuild(keys_.data(), keys_.size());
+		}
+
+		void reserve(const size_type n)
+		{
+			keys_.reserve(n);
+			values_.reserve(n);
+		}
+
+		void shrink_to_fit()
+		{
+			keys_.shrink_to_fit();
+			values_.shrink_to_fit();
+		}
+
+		void clear() noexcept
+		{
+			keys_.clear();
+			values_.clear();
+			index_.clear();
+		}
+
+		template <class Key = K>
+		[[nodiscard]] V& at(const Key& key)
+		{
+			const auto it = find(key);
+			if (it == end()) throw std::out_of_range{""};
+			return it->second;
+		}
+
+		template <class Key = K>
+		[[nodiscard]] const V& at(const Key& key) const { return const_cast<flat_map&>(*this).at(key); }
+
+		V& operator[](const K& key) { return try_emplace(key).first->second; }
+		V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+		template <class Key, class = std::enable_if_t<heterogeneous<Key>>>
+		V& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+		{
+			return try_emplace_impl(key, key, std::forward<Args>(args)...);
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+		{
+			return try_emplace_impl(key, std::move(key), std::forward<Args>(args)...);
+		}
+
+		// Builds the key from key only when inserting
+		template <class Key, class... Args, class = std::enable_if_t<heterogeneous<Key>>>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+		{
+			return try_emplace_impl(key, key, std::forward<Args>(args)...);
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(const K& key, M&& obj)
+		{
+			const auto r = try_emplace(key, std::forward<M>(obj));
+			if (!r.second) r.first->second = std::forward<M>(obj);
+			return r;
+		}
+
+		template <class M>
+		std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj)
+		{
+			const auto r = try_emplace(std::move(key), std::forward<M>(obj));
+			if (!r.second) r.first->second = std::forward<M>(obj);
+			return r;
+		}
+
+		std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+		std::pair<iterator, bool> insert(value_type&& v) { return try_emplace(std::move(v.first), std::move(v.second)); }
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			value_type v(std::forward<Args>(args)...);
+			return insert(std::move(v));
+		}
+
+		// Batch insert: sorts the new elements by key and merges them in one pass. Of elements with equivalent
+		// keys, the one already present or else the first in the range is kept.
+		template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+		void insert(InputIt first, const InputIt last)
+		{
+			key_container_type keys;
+			mapped_container_type values;
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+			{
+				const auto n = static_cast<size_type>(std::distance(first, last));
+				keys.reserve(n);
+				values.reserve(n);
+			}
+			for (; first != last; ++first) Append(keys, values, *first);
+			merge_tail(std::move(keys), std::move(values), false);
+		}
+
+		void insert(const std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+		template <std::ranges::input_range R>
+		void insert_range(R&& rg)
+		{
+			insert_range_impl(std::forward<R>(rg), false);
+		}
+
+		// Like insert_range, but rg must already be sorted by key, so only the merge is done
+		template <std::ranges::input_range R>
+		void merge_sorted(R&& rg)
+		{
+			insert_range_impl(std::forward<R>(rg), true);
+		}
+
+		iterator erase(const const_iterator position) { return erase(position, position + 1); }
+
+		iterator erase(const const_iterator first, const const_iterator last)
+		{
+			keys_.erase(keys_.begin() + first.idx_, keys_.begin() + last.idx_);
+			values_.erase(values_.begin() + first.idx_, values_.begin() + last.idx_);
+			index_.rebuild(keys_.data(), keys_.size());
+			return {keys_.data(), values_.data(), first.idx_};
+		}
+
+		template <class Key = K, class = std::enable_if_t<!std::is_convertible_v<const Key&, const_iterator>>>
+		size_type erase(const Key& key)
+		{
+			const auto it = find(key);
+			if (it == end()) return 0;
+			erase(it);
+			return 1;
+		}
+
+		void swap(flat_map& x) noexcept
+		{
+			using std::swap;
+			keys_.swap(x.keys_);
+			values_.swap(x.values_);
+			swap(index_, x.index_);
+			swap(comp_, x.comp_);
+		}
+
+		template <class Key = K>
+		[[nodiscard]] iterator lower_bound(const Key& key)
+		{
+			const key_arg<Key>& k = key;
+			return begin() + index_.partition_point(keys_.data(), size(), [&](const K& x) { return comp_(x, k); });
+		}
+
+		template <class Key = K>
+		[[nodiscard]] const_iterator lower_bound(const Key& key) const { return const_cast<flat_map&>(*this).lower_bound(key); }
+
+		template <class Key = K>
+		[[nodiscard]] iterator upper_bound(const Key& key)
+		{
+			const key_arg<Key>& k = key;
+			return begin() + index_.partition_point(keys_.data(), size(), [&](const K& x) { return !comp_(k, x); });
+		}
+
+		template <class Key = K>
+		[[nodiscard]] const_iterator upper_bound(const Key& key) const { return const_cast<flat_map&>(*this).upper_bound(key); }
+
+		template <class Key = K>
+		[[nodiscard]] iterator find(const Key& key)
+		{
+			const auto it = lower_bound(key);
+			return it != end() && !comp_(static_cast<const key_arg<Key>&>(key), it->first) ? it : end();
+		}
+
+		template <class Key = K>
+		[[nodiscard]] const_iterator find(const Key& key) const { return const_cast<flat_map&>(*this).find(key); }
+
+		template <class Key = K>
+		[[nodiscard]] bool contains(const Key& key) const { return find(key) != end(); }
+
+		template <class Key = K>
+		[[nodiscard]] size_type count(const Key& key) const { return contains(key); }
+
+		template <class Key = K>
+		[[nodiscard]] std::pair<iterator, iterator> equal_range(const Key& key)
+		{
+			const auto it = find(key);
+			return {it, it == end() ? it : it + 1};
+		}
+
+		template <class Key = K>
+		[[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+		{
+			const auto it = find(key);
+			return {it, it == end() ? it : it + 1};
+		}
+
+	private:
+		template <class Pair>
+		static void Append(key_container_type& keys, mapped_container_type& values, Pair&& kv)
+		{
+			keys.emplace_back(std::get<0>(std::forward<Pair>(kv)));
+			values.emplace_back(std::get<1>(std::forward<Pair>(kv)));
+		}
+
+		template <class R>
+		void insert_range_impl(R&& rg, const bool sorted)
+		{
+			key_container_type keys;
+			mapped_container_type values;
+			if constexpr (std::ranges::sized_range<R>)
+			{
+				const auto n = static_cast<size_type>(std::ranges::size(rg));
+				keys.reserve(n);
+				values.reserve(n);
+			}
+			for (auto&& kv : rg) Append(keys, values, std::forward<decltype(kv)>(kv));
+			merge_tail(std::move(keys), std::move(values), sorted);
+		}
+
+		// key is what k builds, and may refer to it
+		template <class Key, class KeyArg, class... Args>
+		std::pair<iterator, bool> try_emplace_impl(const Key& key, KeyArg&& k, Args&&... args)
+		{
+			const auto pos = lower_bound(key);
+			if (pos != end() && !comp_(static_cast<const key_arg<Key>&>(key), pos->first)) return {pos, false};
+
+			const auto i = pos.idx_;
+			keys_.emplace(keys_.begin() + i, std::forward<KeyArg>(k));
+			try
+			{
+				values_.emplace(values_.begin() + i, std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				keys_.erase(keys_.begin() + i);
+				throw;
+			}
+			index_.rebuild(keys_.data(), keys_.size());
+			return {iterator{keys_.data(), values_.data(), i}, true};
+		}
+
+		// Merges the tail into the map out of place, dropping keys already present and repeats within the tail
+		void merge_tail(key_container_type keys, mapped_container_type values, const bool sorted)
+		{
+			const size_type m = keys.size();
+			if (m == 0) return;
+
+			// Sorting indices keeps the two columns apart; identity when already sorted
+			vector<size_type> order(m);
+			std::iota(order.begin(), order.end(), size_type{0});
+			if (!sorted)
+				std::stable_sort(order.begin(), order.end(), [&](const size_type a, const size_type b) { return comp_(keys[a], keys[b]); });
+
+			key_container_type merged_keys;
+			mapped_container_type merged_values;
+			merged_keys.reserve(size() + m);
+			merged_values.reserve(size() + m);
+			try
+			{
+				size_type a = 0, b = 0;
+				const size_type n = size();
+				while (a != n || b != m)
+				{
+					if (b == m || (a != n && !comp_(keys[order[b]], keys_[a])))
+					{
+						merged_keys.push_back(std::move(keys_[a]));
+						merged_values.push_back(std::move(values_[a]));
+						++a;
+					}
+					else if (merged_keys.empty() || comp_(merged_keys.back(), keys[order[b]]))
+					{
+						merged_keys.push_back(std::move(keys[order[b]]));
+						merged_values.push_back(std::move(values[order[b]]));
+						++b;
+					}
+					else
+					{
+						++b;
+					}
+				}
+			}
+			catch (...)
+			{
+				// Some elements were moved from
+				clear();
+				throw;
+			}
+			replace(std::move(merged_keys), std::move(merged_values));
+		}
+
+		key_container_type keys_;
+		mapped_container_type values_;
+		[[no_unique_address]] internal::FlatIndex<K, Search> index_;
+		[[no_unique_address]] Compare comp_;
+	};
+
+	template <class K, class V, class Compare, class Search>
+	[[nodiscard]] bool operator==(const flat_map<K, V, Compare, Search>& lhs, const flat_map<K, V, Compare, Search>& rhs)
+	{
+		return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+	}
+
+	template <class K, class V, class Compare, class Search>
+	[[nodiscard]] bool operator!=(const flat_map<K, V, Compare, Search>& lhs, const flat_map<K, V, Compare, Search>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class K, class V, class Compare, class Search>
+	void swap(flat_map<K, V, Compare, Search>& lhs, flat_map<K, V, Compare, Search>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	// pred is called with a const_reference
+	template <class K, class V, class Compare, class Search, class Pred>
+	size_t erase_if(flat_map<K, V, Compare, Search>& c, Pred pred)
+	{
+		auto [keys, values] = std::move(c).extract();
+		size_t out = 0;
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			if (pred(std::pair<const K&, const V&>{keys[i], values[i]})) continue;
+			if (out != i)
+			{
+				keys[out] = std::move(keys[i]);
+				values[out] = std::move(values[i]);
+			}
+			++out;
+		}
+		const size_t n = keys.size() - out;
+		keys.erase(keys.begin() + out, keys.end());
+		values.erase(values.begin() + out, values.end());
+		c.replace(std::move(keys), std::move(values));
+		return n;
+	}
+}
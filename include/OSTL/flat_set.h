@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include "internal/flat_tree.h"
+#include "vector.h"
+
+namespace ostl
+{
+	// Sorted set in one contiguous ostl::vector: lookups are binary searches over packed keys, and iteration is
+	// a linear scan. A single insert or erase shifts the tail, so build with insert_range or merge_sorted,
+	// which append the new keys, sort them, and merge them in once. Search selects the lookup layout (see
+	// ostl::search). With a transparent Compare, lookups take any key comparable with K.
+	template <class K, class Compare = std::less<K>, class Search = search::branchless>
+	class flat_set
+	{
+		template <class Key>
+		using key_arg = std::conditional_t<internal::IsTransparent<Compare>, Key, K>;
+
+	public:
+		using key_type = K;
+		using value_type = K;
+		using key_compare = Compare;
+		using value_compare = Compare;
+		using container_type = vector<K>;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = const K&;
+		using const_reference = const K&;
+		using iterator = typename container_type::const_iterator;
+		using const_iterator = iterator;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = reverse_iterator;
+
+		flat_set() = default;
+
+		explicit flat_set(const Compare& comp) : comp_{comp}
+		{
+		}
+
+		template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+		flat_set(InputIt first, const InputIt last, const Compare& comp = Compare{}) : comp_{comp}
+		{
+			insert(first, last);
+		}
+
+		flat_set(const std::initializer_list<K> init, const Compare& comp = Compare{}) : flat_set{init.begin(), init.end(), comp}
+		{
+		}
+
+		// Takes keys in any order
+		explicit flat_set(container_type keys, const Compare& comp = Compare{}) : comp_{comp}
+		{
+			merge_tail(std::move(keys), false);
+		}
+
+		flat_set& operator=(const std::initializer_list<K> init)
+		{
+			clear();
+			insert(init);
+			return *this;
+		}
+
+		[[nodiscard]] iterator begin() const noexcept { return keys_.begin(); }
+		[[nodiscard]] iterator cbegin() const noexcept { return keys_.begin(); }
+		[[nodiscard]] iterator end() const noexcept { return keys_.end(); }
+		[[nodiscard]] iterator cend() const noexcept { return keys_.end(); }
+		[[nodiscard]] reverse_iterator rbegin() const noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] reverse_iterator crbegin() const noexcept { return rbegin(); }
+		[[nodiscard]] reverse_iterator rend() const noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] reverse_iterator crend() const noexcept { return rend(); }
+
+		[[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+		[[nodiscard]] size_type size() const noexcept { return keys_.size(); }
+		[[nodiscard]] size_type max_size() const noexcept { return keys_.max_size(); }
+		[[nodiscard]] key_compare key_comp() const { return comp_; }
+		[[nodiscard]] value_compare value_comp() const { return comp_; }
+
+		// The sorted keys
+		[[nodiscard]] const container_type& keys() const noexcept { return keys_; }
+
+		// Takes the keys out, leaving the set empty
+		[[nodiscard]] container_type extract() &&
+		{
+			container_type keys = std::move(keys_);
+			clear();
+			return keys;
+		}
+
+		// keys must be sorted and unique
+		void replace(container_type&& keys)
+		{
+			keys_ = std::move(keys);
+			index_.rebuild(keys_.data(), keys_.size());
+		}
+
+		void reserve(const size_type n) { keys_.reserve(n); }
+		void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+		void clear() noexcept
+		{
+			keys_.clear();
+			index_.clear();
+		}
+
+		std::pair<iterator, bool> insert(const K& x) { return emplace_key(x, x); }
+		std::pair<iterator, bool> insert(K&& x) { return emplace_key(x, std::move(x)); }
+		iterator insert(const_iterator, const K& x) { return insert(x).first; }
+		iterator insert(const_iterator, K&& x) { return insert(std::move(x)).first; }
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			K x(std::forward<Args>(args)...);
+			return emplace_key(x, std::move(x));
+		}
+
+		// Batch insert: sorts the new keys and merges them in one pass. Of equivalent keys, the one already
+		// present or else the first in the range is kept.
+		template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+		void insert(InputIt first, const InputIt last)
+		{
+			merge_tail(container_type(first, last), false);
+		}
+
+		void insert(const std::initializer_list<K> init) { insert(init.begin(), init.end()); }
+
+		template <std::ranges::input_range R>
+		void insert_range(R&& rg)
+		{
+			merge_tail(Collect(std::forward<R>(rg)), false);
+		}
+
+		// Like insert_range, but rg must already be sorted by Compare, so only the merge is done
+		template <std::ranges::input_range R>
+		void merge_sorted(R&& rg)
+		{
+			merge_tail(Collect(std::forward<R>(rg)), true);
+		}
+
+		iterator erase(const const_iterator position)
+		{
+			const auto it = keys_.erase(position);
+			index_.rebuild(keys_.data(), keys_.size());
+			return it;
+		}
+
+		iterator erase(const const_iterator first, const const_iterator last)
+		{
+			const auto it = keys_.erase(first, last);
+			index_.rebuild(keys_.data(), keys_.size());
+			return it;
+		}
+
+		template <class Key = K, class = std::enable_if_t<!std::is_convertible_v<const Key&, const_iterator>>>
+		size_type erase(const Key& key)
+		{
+			const auto it = find(key);
+			if (it == end()) return 0;
+			erase(it);
+			return 1;
+		}
+
+		void swap(flat_set& x) noexcept
+		{
+			using std::swap;
+			keys_.swap(x.keys_);
+			swap(index_, x.index_);
+			swap(comp_, x.comp_);
+		}
+
+		template <class Key = K>
+		[[nodiscard]] iterator lower_bound(const Key& key) const
+		{
+			const key_arg<Key>& k = key;
+			return begin() + index_.partition_point(keys_.data(), size(), [&](const K& x) { return comp_(x, k); });
+		}
+
+		template <class Key = K>
+		[[nodiscard]] iterator upper_bound(const Key& key) const
+		{
+			const key_arg<Key>& k = key;
+			return begin() + index_.partition_point(keys_.data(), size(), [&](const K& x) { return !comp_(k, x); });
+		}
+
+		template <class Key = K>
+		[[nodiscard]] iterator find(const Key& key) const
+		{
+			const auto it = lower_bound(key);
+			return it != end() && !comp_(static_cast<const key_arg<Key>&>(key), *it) ? it : end();
+		}
+
+		template <class Key = K>
+		[[nodiscard]] bool contains(const Key& key) const { return find(key) != end(); }
+
+		template <class Key = K>
+		[[nodiscard]] size_type count(const Key& key) const { return contains(key); }
+
+		template <class Key = K>
+		[[nodiscard]] std::pair<iterator, iterator> equal_range(const Key& key) const
+		{
+			const auto it = find(key);
+			return {it, it == end() ? it : it + 1};
+		}
+
+	private:
+		template <class R>
+		[[nodiscard]] static container_type Collect(R&& rg)
+		{
+			container_type tail;
+			if constexpr (std::ranges::sized_range<R>) tail.reserve(static_cast<size_type>(std::ranges::size(rg)));
+			for (auto&& x : rg) tail.emplace_back(std::forward<decltype(x)>(x));
+			return tail;
+		}
+
+		// x may refer to key
+		template <class Arg>
+		std::pair<iterator, bool> emplace_key(const K& key, Arg&& x)
+		{
+			const auto pos = lower_bound(key);
+			if (pos != end() && !comp_(key, *pos)) return {pos, false};
+			const auto it = keys_.emplace(pos, std::forward<Arg>(x));
+			index_.rebuild(keys_.data(), keys_.size());
+			return {it, true};
+		}
+
+		// Merges tail into the keys out of place, dropping keys already present and repeats within tail
+		void merge_tail(container_type tail, const bool sorted)
+		{
+			if (tail.empty()) return;
+			if (!sorted) std::stable_sort(tail.begin(), tail.end(), comp_);
+
+			container_type merged;
+			merged.reserve(keys_.size() + tail.size());
+			try
+			{
+				auto a = keys_.begin(), b = tail.begin();
+				const auto a_end = keys_.end(), b_end = tail.end();
+				while (a != a_end || b != b_end)
+				{
+					if (b == b_end || (a != a_end && !comp_(*b, *a)))
+					{
+						merged.push_back(std::move(*a++));
+					}
+					else if (merged.empty() || comp_(merged.back(), *b))
+					{
+						merged.push_back(std::move(*b++));
+					}
+					else
+					{
+						++b;
+					}
+				}
+			}
+			catch (...)
+			{
+				// Some keys were moved from
+				clear();
+				throw;
+			}
+			replace(std::move(merged));
+		}
+
+		container_type keys_;
+		[[no_unique_address]] internal::FlatIndex<K, Search> index_;
+		[[no_unique_address]] Compare comp_;
+	};
+
+	template <class K, class Compare, class Search>
+	[[nodiscard]] bool operator==(const flat_set<K, Compare, Search>& lhs, const flat_set<K, Compare, Search>& rhs)
+	{
+		return lhs.keys() == rhs.keys();
+	}
+
+	template <class K, class Compare, class Search>
+	[[nodiscard]] bool operator!=(const flat_set<K, Compare, Search>& lhs, const flat_set<K, Compare, Search>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class K, class Compare, class Search>
+	void swap(flat_set<K, Compare, Search>& lhs, flat_set<K, Compare, Search>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	template <class K, class Compare, class Search, class Pred>
+	size_t erase_if(flat_set<K, Compare, Search>& c, Pred pred)
+	{
+		auto keys = std::move(c).extract();
+		const auto it = std::remove_if(keys.begin(), keys.end(), pred);
+		const auto n = static_cast<size_t>(keys.end() - it);
+		keys.erase(it, keys.end());
+		c.replace(std::move(keys));
+		return n;
+	}
+}
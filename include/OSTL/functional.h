@@ -4,6 +4,8 @@
 
 #include <memory>
 #include <functional>
+#include <string>
+#include <string_view>
 #include "cstddef.h"
 
 namespace ostl
@@ -158,4 +160,54 @@ namespace ostl
 		if (!*this) throw bad_function_call{};
 		return (*f_)(std::forward<Args>(args)...);
 	}
+
+	// Hashes any string-like argument through std::string_view, so hash containers keyed by strings can be
+	// probed with a std::string_view or literal without building a key
+	struct string_hash
+	{
+		using is_transparent = void;
+
+		[[nodiscard]] size_t operator()(const std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+	};
+
+	// Defaults for the hash containers: std::hash and std::equal_to, made transparent for strings
+	template <class T>
+	struct hash : std::hash<T>
+	{
+	};
+
+	template <>
+	struct hash<std::string> : string_hash
+	{
+	};
+
+	template <>
+	struct hash<std::string_view> : string_hash
+	{
+	};
+
+	template <class T>
+	struct equal_to : std::equal_to<T>
+	{
+	};
+
+	template <>
+	struct equal_to<std::string> : std::equal_to<>
+	{
+	};
+
+	template <>
+	struct equal_to<std::string_view> : std::equal_to<>
+	{
+	};
+
+	namespace internal
+	{
+		// Comparators and hashers declaring is_transparent accept any key type they can compare
+		template <class T, class = void>
+		inline constexpr bool IsTransparent = false;
+
+		template <class T>
+		inline constexpr bool IsTransparent<T, std::void_t<typename T::is_transparent>> = true;
+	}
 }
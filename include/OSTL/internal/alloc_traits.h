@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include "../type_traits.h"
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define OSTL_MALLOC_USABLE_SIZE _msize
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#define OSTL_MALLOC_USABLE_SIZE malloc_usable_size
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define OSTL_MALLOC_USABLE_SIZE malloc_size
+#endif
+
+namespace ostl
+{
+	template <class T>
+	class malloc_allocator;
+}
+
+namespace ostl::internal
+{
+	template <class Alloc, class T, class = void>
+	struct HasConstruct : std::false_type {};
+
+	template <class Alloc, class T>
+	struct HasConstruct<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().construct(std::declval<T*>(), std::declval<T&&>()))>>
+		: std::true_type {};
+
+	template <class Alloc, class T, class = void>
+	struct HasDestroy : std::false_type {};
+
+	template <class Alloc, class T>
+	struct HasDestroy<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().destroy(std::declval<T*>()))>>
+		: std::true_type {};
+
+	// Whether allocator_traits<Alloc>::construct/destroy boil down to placement new and ~T()
+	template <class Alloc, class T>
+	struct IsPlainConstruct : std::bool_constant<!HasConstruct<Alloc, T>::value && !HasDestroy<Alloc, T>::value> {};
+
+	template <class T>
+	struct IsPlainConstruct<std::allocator<T>, T> : std::true_type {};
+
+	template <class T>
+	struct IsPlainConstruct<std::pmr::polymorphic_allocator<T>, T>
+		: std::bool_constant<!std::uses_allocator_v<T, std::pmr::polymorphic_allocator<T>>> {};
+
+	template <class T, class Alloc>
+	inline constexpr bool CanRelocate = is_trivially_relocatable_v<T> && IsPlainConstruct<Alloc, T>::value
+		&& std::is_pointer_v<typename std::allocator_traits<Alloc>::pointer>;
+
+	template <class T, class Alloc>
+	inline constexpr bool CanBulkCopy = std::is_trivially_copyable_v<T> && IsPlainConstruct<Alloc, T>::value
+		&& std::is_pointer_v<typename std::allocator_traits<Alloc>::pointer>;
+
+	// Alignment every block from Alloc is known to have: Alloc::alignment if it declares one
+	template <class Alloc, class = void>
+	inline constexpr size_t AllocAlignment = alignof(typename std::allocator_traits<Alloc>::value_type);
+
+	template <class Alloc>
+	inline constexpr size_t AllocAlignment<Alloc, std::void_t<decltype(Alloc::alignment)>> = Alloc::alignment;
+
+	template <class Pointer>
+	struct AllocationResult
+	{
+		Pointer ptr;
+		size_t count;
+	};
+
+	template <class Alloc, class = void>
+	struct HasAllocateAtLeast : std::false_type {};
+
+	template <class Alloc>
+	struct HasAllocateAtLeast<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(size_t{}))>>
+		: std::true_type {};
+
+	// Allocators that can resize their own blocks: reallocate(p, old_n, new_n) returns an AllocationResult
+	template <class Alloc, class = void>
+	struct HasReallocate : std::false_type {};
+
+	template <class Alloc>
+	struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+		std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>>
+		: std::true_type {};
+
+	// Allocators whose blocks come straight from malloc, so their usable size can be queried and they can be
+	// resized with realloc. Only malloc_allocator opts in; std::allocator keeps going through operator new.
+	template <class Alloc>
+	struct UsesMalloc : std::false_type {};
+
+	template <class T>
+	struct UsesMalloc<malloc_allocator<T>> : std::true_type {};
+
+	template <class Alloc>
+	[[nodiscard]] AllocationResult<typename std::allocator_traits<Alloc>::pointer> AllocateAtLeast(Alloc& alloc, const size_t n)
+	{
+		using T = typename std::allocator_traits<Alloc>::value_type;
+
+		if constexpr (HasAllocateAtLeast<Alloc>::value)
+		{
+			const auto r = alloc.allocate_at_least(n);
+			return {r.ptr, static_cast<size_t>(r.count)};
+		}
+		else if constexpr (UsesMalloc<Alloc>::value)
+		{
+			const auto p = std::allocator_traits<Alloc>::allocate(alloc, n);
+#ifdef OSTL_MALLOC_USABLE_SIZE
+			return {p, p ? OSTL_MALLOC_USABLE_SIZE(p) / sizeof(T) : 0};
+#else
+			return {p, n};
+#endif
+		}
+		else
+		{
+#ifdef __cpp_lib_allocate_at_least
+			const auto r = std::allocator_traits<Alloc>::allocate_at_least(alloc, n);
+			return {r.ptr, static_cast<size_t>(r.count)};
+#else
+			return {std::allocator_traits<Alloc>::allocate(alloc, n), n};
+#endif
+		}
+	}
+
+	// Grows or shrinks a block of old_n elements, in place when the allocator or heap allows it.
+	// Elements are moved bytewise, so callers must only use this for trivially relocatable types.
+	template <class Alloc>
+	[[nodiscard]] AllocationResult<typename std::allocator_traits<Alloc>::pointer> Reallocate(Alloc& alloc, typename std::allocator_traits<Alloc>::pointer p, const size_t old_n, const size_t n)
+	{
+		using T = typename std::allocator_traits<Alloc>::value_type;
+
+		if constexpr (HasReallocate<Alloc>::value)
+		{
+			const auto r = alloc.reallocate(p, old_n, n);
+			return {r.ptr, static_cast<size_t>(r.count)};
+		}
+		else
+		{
+			static_assert(UsesMalloc<Alloc>::value);
+
+			if (n == 0)
+			{
+				std::free(p);
+				return {nullptr, 0};
+			}
+			if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length{};
+			void* const q = std::realloc(p, n * sizeof(T));
+			if (!q) throw std::bad_alloc{};
+#ifdef OSTL_MALLOC_USABLE_SIZE
+			return {static_cast<T*>(q), OSTL_MALLOC_USABLE_SIZE(q) / sizeof(T)};
+#else
+			return {static_cast<T*>(q), n};
+#endif
+		}
+	}
+
+	template <class Alloc>
+	void Deallocate(Alloc& alloc, typename std::allocator_traits<Alloc>::pointer p, const size_t n) noexcept
+	{
+		std::allocator_traits<Alloc>::deallocate(alloc, p, n);
+	}
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <type_traits>
+#include "bits.h"
+
+// Lazy word-wise expressions over vector<bool> (a & b & ~c, ...), evaluated in a single pass on assignment.
+// Operands shorter than the expression read as zero-extended. Nodes hold their operands by value and
+// leaves point into the vectors, so only the vectors themselves need to outlive an expression.
+namespace ostl::internal
+{
+	struct BitAnd
+	{
+		Word operator()(const Word a, const Word b) const noexcept { return a & b; }
+#ifdef OSTL_X64
+		OSTL_TARGET("avx2") __m256i operator()(const __m256i a, const __m256i b) const noexcept { return _mm256_and_si256(a, b); }
+#endif
+	};
+
+	struct BitOr
+	{
+		Word operator()(const Word a, const Word b) const noexcept { return a | b; }
+#ifdef OSTL_X64
+		OSTL_TARGET("avx2") __m256i operator()(const __m256i a, const __m256i b) const noexcept { return _mm256_or_si256(a, b); }
+#endif
+	};
+
+	struct BitXor
+	{
+		Word operator()(const Word a, const Word b) const noexcept { return a ^ b; }
+#ifdef OSTL_X64
+		OSTL_TARGET("avx2") __m256i operator()(const __m256i a, const __m256i b) const noexcept { return _mm256_xor_si256(a, b); }
+#endif
+	};
+
+	struct BitAndNot
+	{
+		Word operator()(const Word a, const Word b) const noexcept { return a & ~b; }
+#ifdef OSTL_X64
+		OSTL_TARGET("avx2") __m256i operator()(const __m256i a, const __m256i b) const noexcept { return _mm256_andnot_si256(b, a); }
+#endif
+	};
+
+	struct BitAssign
+	{
+		Word operator()(Word, const Word b) const noexcept { return b; }
+#ifdef OSTL_X64
+		OSTL_TARGET("avx2") __m256i operator()(__m256i, const __m256i b) const noexcept { return b; }
+#endif
+	};
+
+	struct BitExprBase {};
+
+	template <class T>
+	inline constexpr bool IsBitExpr = std::is_base_of_v<BitExprBase, T>;
+
+	// Specialized for vector<bool> in vector.h
+	template <class T>
+	inline constexpr bool IsBoolVector = false;
+
+	template <class T>
+	inline constexpr bool IsBitOperand = IsBitExpr<T> || IsBoolVector<T>;
+
+	struct BitLeaf : BitExprBase
+	{
+		BitLeaf(const Word* words, const size_t bits) noexcept : words_{words}, bits_{bits} {}
+
+		[[nodiscard]] size_t size() const noexcept { return bits_; }
+
+		// Words [0, full_words()) can be read without bounds checks
+		[[nodiscard]] size_t full_words() const noexcept { return bits_ / word_bits; }
+
+		[[nodiscard]] Word word(const size_t i) const noexcept
+		{
+			const size_t full = bits_ / word_bits;
+			if (i < full) return words_[i];
+			if (i == full && bits_ % word_bits) return words_[i] & LowMask(bits_ % word_bits);
+			return 0;
+		}
+
+#ifdef OSTL_X64
+		[[nodiscard]] OSTL_TARGET("avx2") __m256i block(const size_t i) const noexcept
+		{
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words_ + i));
+		}
+#endif
+
+	private:
+		const Word* words_;
+		size_t bits_;
+	};
+
+	template <class E>
+	struct BitNot : BitExprBase
+	{
+		explicit BitNot(const E& e) noexcept : e_{e} {}
+
+		[[nodiscard]] size_t size() const noexcept { return e_.size(); }
+		[[nodiscard]] size_t full_words() const noexcept { return e_.full_words(); }
+		[[nodiscard]] Word word(const size_t i) const noexcept { return ~e_.word(i); }
+
+#ifdef OSTL_X64
+		[[nodiscard]] OSTL_TARGET("avx2") __m256i block(const size_t i) const noexcept
+		{
+			return _mm256_xor_si256(e_.block(i), _mm256_set1_epi64x(-1));
+		}
+#endif
+
+	private:
+		E e_;
+	};
+
+	template <class Op, class L, class R>
+	struct BitBinary : BitExprBase
+	{
+		BitBinary(const L& l, const R& r) noexcept : l_{l}, r_{r} {}
+
+		[[nodiscard]] size_t size() const noexcept { return std::max(l_.size(), r_.size()); }
+		[[nodiscard]] size_t full_words() const noexcept { return std::min(l_.full_words(), r_.full_words()); }
+		[[nodiscard]] Word word(const size_t i) const noexcept { return Op{}(l_.word(i), r_.word(i)); }
+
+#ifdef OSTL_X64
+		[[nodiscard]] OSTL_TARGET("avx2") __m256i block(const size_t i) const noexcept
+		{
+			return Op{}(l_.block(i), r_.block(i));
+		}
+#endif
+
+	private:
+		L l_;
+		R r_;
+	};
+
+	template <class T>
+	[[nodiscard]] auto ToBitExpr(const T& x) noexcept
+	{
+		if constexpr (IsBitExpr<T>) return x;
+		else return BitLeaf{x.words(), x.size()};
+	}
+
+	template <class T>
+	using BitExprOf = decltype(ToBitExpr(std::declval<const T&>()));
+
+#ifdef OSTL_X64
+	template <class Op, class E>
+	OSTL_TARGET("avx2") size_t EvalBitsAvx2(Word* dst, const size_t n, const E& e, const Op op) noexcept
+	{
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			const auto d = reinterpret_cast<__m256i*>(dst + i);
+			_mm256_storeu_si256(d, op(_mm256_loadu_si256(d), e.block(i)));
+		}
+		return i;
+	}
+#endif
+
+	// dst[i] = op(dst[i], e.word(i)) for every i < n. Each word only depends on the same word of
+	// the operands, so e may refer to dst.
+	template <class Op, class E>
+	void EvalBits(Word* dst, const size_t n, const E& e, const Op op) noexcept
+	{
+		size_t i = 0;
+#ifdef OSTL_X64
+		if (HasAvx2()) i = EvalBitsAvx2(dst, std::min(n, e.full_words()), e, op);
+#endif
+		for (; i < n; ++i) dst[i] = op(dst[i], e.word(i));
+	}
+
+	template <class L, class R, class = std::enable_if_t<IsBitOperand<L> && IsBitOperand<R>>>
+	[[nodiscard]] auto operator&(const L& l, const R& r) noexcept
+	{
+		return BitBinary<BitAnd, BitExprOf<L>, BitExprOf<R>>{ToBitExpr(l), ToBitExpr(r)};
+	}
+
+	template <class L, class R, class = std::enable_if_t<IsBitOperand<L> && IsBitOperand<R>>>
+	[[nodiscard]] auto operator|(const L& l, const R& r) noexcept
+	{
+		return BitBinary<BitOr, BitExprOf<L>, BitExprOf<R>>{ToBitExpr(l), ToBitExpr(r)};
+	}
+
+	template <class L, class R, class = std::enable_if_t<IsBitOperand<L> && IsBitOperand<R>>>
+	[[nodiscard]] auto operator^(const L& l, const R& r) noexcept
+	{
+		return BitBinary<BitXor, BitExprOf<L>, BitExprOf<R>>{ToBitExpr(l), ToBitExpr(r)};
+	}
+
+	template <class E, class = std::enable_if_t<IsBitOperand<E>>>
+	[[nodiscard]] auto operator~(const E& e) noexcept
+	{
+		return BitNot<BitExprOf<E>>{ToBitExpr(e)};
+	}
+
+	template <class L, class R, class = std::enable_if_t<IsBitOperand<L> && IsBitOperand<R>>>
+	[[nodiscard]] auto and_not(const L& l, const R& r) noexcept
+	{
+		return BitBinary<BitAndNot, BitExprOf<L>, BitExprOf<R>>{ToBitExpr(l), ToBitExpr(r)};
+	}
+}
+
+namespace ostl
+{
+	using internal::operator&;
+	using internal::operator|;
+	using internal::operator^;
+	using internal::operator~;
+	using internal::and_not;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include "cpu.h"
+
+#ifdef OSTL_X64
+#include <immintrin.h>
+#endif
+
+namespace ostl::internal
+{
+	using Word = size_t;
+	inline constexpr size_t word_bits = sizeof(Word) * 8;
+
+	// Mask of the low n bits, n in [0, word_bits]
+	[[nodiscard]] constexpr Word LowMask(const size_t n) noexcept
+	{
+		return n >= word_bits ? ~Word{0} : (Word{1} << n) - 1;
+	}
+
+	// Reads n <= word_bits bits starting at bit pos into the low bits of the result.
+	// Never touches a word that holds none of the requested bits.
+	[[nodiscard]] inline Word ExtractBits(const Word* words, const size_t pos, const size_t n) noexcept
+	{
+		const size_t w = pos / word_bits, off = pos % word_bits;
+		Word v = words[w] >> off;
+		if (off + n > word_bits) v |= words[w + 1] << (word_bits - off);
+		return v & LowMask(n);
+	}
+
+	// Overwrites n <= word_bits - pos % word_bits bits starting at bit pos, which must lie in one word
+	inline void DepositBits(Word* words, const size_t pos, const size_t n, const Word v) noexcept
+	{
+		const size_t off = pos % word_bits;
+		const Word mask = LowMask(n) << off;
+		Word& w = words[pos / word_bits];
+		w = (w & ~mask) | ((v << off) & mask);
+	}
+
+	// Sets or clears n bits starting at bit pos. Only the partial edge words are masked; whole words are memset.
+	inline void FillBits(Word* words, size_t pos, size_t n, const bool value) noexcept
+	{
+		const Word fill = Word{0} - value;
+		const size_t head = std::min(n, (word_bits - pos % word_bits) % word_bits);
+		if (head) DepositBits(words, pos, head, fill);
+		pos += head;
+		n -= head;
+
+		const size_t whole = n / word_bits;
+		if (whole) std::memset(words + pos / word_bits, value ? 0xff : 0, whole * sizeof(Word));
+		if (n %= word_bits) DepositBits(words, pos + whole * word_bits, n, fill);
+	}
+
+	// memmove for bit ranges: copies n bits from src at bit sbit to dst at bit dbit. The ranges may overlap.
+	inline void CopyBits(Word* dst, size_t dbit, const Word* src, size_t sbit, size_t n) noexcept
+	{
+		if (n == 0 || (dst == src && dbit == sbit)) return;
+
+		if (dbit % word_bits == sbit % word_bits)
+		{
+			// Same phase: fix up the partial edge words and memmove the whole words between them
+			const size_t head = std::min(n, (word_bits - dbit % word_bits) % word_bits);
+			const size_t whole = (n - head) / word_bits;
+			const size_t tail = n - head - whole * word_bits;
+			const Word headBits = head ? ExtractBits(src, sbit, head) : 0;
+			const Word tailBits = tail ? ExtractBits(src, sbit + n - tail, tail) : 0;
+			if (whole)
+			{
+				std::memmove(dst + (dbit + head) / word_bits, src + (sbit + head) / word_bits,
+				             whole * sizeof(Word));
+			}
+			if (head) DepositBits(dst, dbit, head, headBits);
+			if (tail) DepositBits(dst, dbit + n - tail, tail, tailBits);
+			return;
+		}
+
+		const bool forward = dst != src || dbit < sbit;
+		if (forward)
+		{
+			// Every destination word is written after the source bits it overlaps have been read
+			while (n)
+			{
+				const size_t take = std::min(n, word_bits - dbit % word_bits);
+				DepositBits(dst, dbit, take, ExtractBits(src, sbit, take));
+				dbit += take;
+				sbit += take;
+				n -= take;
+			}
+		}
+		else
+		{
+			while (n)
+			{
+				const size_t end = dbit + n;
+				const size_t take = std::min(n, (end - 1) % word_bits + 1);
+				DepositBits(dst, end - take, take, ExtractBits(src, sbit + n - take, take));
+				n -= take;
+			}
+		}
+	}
+
+	// Position of the r-th (0-based) set bit of w, which must have more than r set bits
+	[[nodiscard]] inline size_t SelectInWord(Word w, size_t r) noexcept
+	{
+		size_t pos = 0;
+		for (;; pos += 8, w >>= 8)
+		{
+			const size_t c = std::popcount(w & 0xff);
+			if (r < c) break;
+			r -= c;
+		}
+		for (; r; --r) w &= w - 1;
+		return pos + std::countr_zero(w);
+	}
+
+#ifdef OSTL_X64
+	// Nibble-lookup popcount (Mula), byte counters flushed every 31 blocks before they can overflow
+	OSTL_TARGET("avx2,popcnt") inline size_t PopCountAvx2(const Word* words, const size_t n) noexcept
+	{
+		const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		                                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low = _mm256_set1_epi8(0x0f);
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i acc = zero;
+		size_t i = 0;
+		while (i + 4 <= n)
+		{
+			__m256i local = zero;
+			for (auto j = 0; j < 31 && i + 4 <= n; ++j, i += 4)
+			{
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+				const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+				local = _mm256_add_epi8(local, _mm256_add_epi8(lo, hi));
+			}
+			acc = _mm256_add_epi64(acc, _mm256_sad_epu8(local, zero));
+		}
+		size_t count = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+			+ _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+		for (; i < n; ++i) count += _mm_popcnt_u64(words[i]);
+		return count;
+	}
+
+	// Index of the first word in [from, n) that differs from flip, or n
+	OSTL_TARGET("avx2") inline size_t FindWordAvx2(const Word* words, size_t from, const size_t n, const Word flip) noexcept
+	{
+		const __m256i f = _mm256_set1_epi64x(static_cast<long long>(flip));
+		for (; from + 4 <= n; from += 4)
+		{
+			const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + from)), f);
+			if (!_mm256_testz_si256(v, v)) break;
+		}
+		for (; from < n; ++from)
+			if (words[from] != flip) return from;
+		return n;
+	}
+#endif
+
+	[[nodiscard]] inline size_t PopCount(const Word* words, const size_t n) noexcept
+	{
+#ifdef OSTL_X64
+		if (HasAvx2()) return PopCountAvx2(words, n);
+#endif
+		size_t count = 0;
+		for (size_t i = 0; i < n; ++i) count += std::popcount(words[i]);
+		return count;
+	}
+
+	// Index of the first word in [from, n) that differs from flip (0 to find set bits, ~0 to find unset ones), or n
+	[[nodiscard]] inline size_t FindWord(const Word* words, size_t from, const size_t n, const Word flip) noexcept
+	{
+#ifdef OSTL_X64
+		if (HasAvx2()) return FindWordAvx2(words, from, n, flip);
+#endif
+		for (; from < n; ++from)
+			if (words[from] != flip) return from;
+		return n;
+	}
+}
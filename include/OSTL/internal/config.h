@@ -0,0 +1,28 @@
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define OSTL_NOINLINE __declspec(noinline)
+#else
+#define OSTL_NOINLINE __attribute__((noinline, cold))
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define OSTL_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define OSTL_PREFETCH(p) ((void)(p))
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OSTL_X64 1
+#endif
+
+// Compiles one function for a wider instruction set than the rest of the program; callers must check the CPU first
+#if defined(OSTL_X64) && (defined(__GNUC__) || defined(__clang__))
+#define OSTL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define OSTL_TARGET(isa)
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OSTL_HAS_MMAP 1
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "config.h"
+
+#if defined(OSTL_X64) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace ostl::internal
+{
+	[[nodiscard]] inline bool HasAvx2() noexcept
+	{
+#if defined(OSTL_X64) && (defined(__GNUC__) || defined(__clang__))
+		static const bool has = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+		return has;
+#elif defined(OSTL_X64) && defined(_MSC_VER)
+		static const bool has = []
+		{
+			int r[4];
+			__cpuid(r, 0);
+			if (r[0] < 7) return false;
+			__cpuid(r, 1);
+			const bool popcnt = r[2] & 1 << 23, osxsave = r[2] & 1 << 27, avx = r[2] & 1 << 28;
+			if (!popcnt || !osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+			__cpuidex(r, 7, 0);
+			return (r[1] & 1 << 5) != 0;
+		}();
+		return has;
+#else
+		return false;
+#endif
+	}
+}
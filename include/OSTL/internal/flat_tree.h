@@ -0,0 +1,125 @@
+#pragma once
+
+#include <bit>
+#include <utility>
+#include "../aligned_allocator.h"
+#include "../functional.h"
+#include "../vector.h"
+#include "config.h"
+
+namespace ostl
+{
+	// Lookup layouts for flat_map and flat_set
+	namespace search
+	{
+		// Binary search over the sorted keys whose loop body compiles to a conditional move, so the
+		// unpredictable comparison costs no mispredictions. Needs no extra memory.
+		struct branchless
+		{
+		};
+
+		// Keeps a copy of the keys in breadth-first (Eytzinger) order next to the sorted ones. The first levels
+		// of the search share a few cache lines and the next levels are prefetched, which pays off for large,
+		// read-mostly tables. Every modification rebuilds the copy in O(n); batch them with insert_range.
+		struct eytzinger
+		{
+		};
+	}
+
+	namespace internal
+	{
+		// First index in [0, n) for which pred is false; keys must be partitioned by pred
+		template <class T, class Pred>
+		[[nodiscard]] size_t BranchlessPartitionPoint(const T* const first, size_t n, Pred pred)
+		{
+			if (n == 0) return 0;
+			const T* base = first;
+			while (n > 1)
+			{
+				const size_t half = n / 2;
+				base = pred(base[half]) ? base + half : base;
+				n -= half;
+			}
+			return static_cast<size_t>(base - first) + pred(*base);
+		}
+
+		template <class K, class Search>
+		class FlatIndex;
+
+		template <class K>
+		class FlatIndex<K, search::branchless>
+		{
+		public:
+			void rebuild(const K*, size_t) {}
+			void clear() noexcept {}
+
+			template <class Pred>
+			[[nodiscard]] size_t partition_point(const K* keys, const size_t n, Pred pred) const
+			{
+				return BranchlessPartitionPoint(keys, n, pred);
+			}
+		};
+
+		template <class K>
+		class FlatIndex<K, search::eytzinger>
+		{
+		public:
+			// Node k (1-based) is at keys_[k - 1], its children are nodes 2k and 2k + 1
+			void rebuild(const K* const sorted, const size_t n)
+			{
+				clear();
+				keys_.reserve(n);
+				ranks_.resize(n + 1);
+				ranks_[0] = n;
+				fill(1, 0, n);
+				for (size_t k = 1; k <= n; ++k) keys_.push_back(sorted[ranks_[k]]);
+			}
+
+			void clear() noexcept
+			{
+				keys_.clear();
+				ranks_.clear();
+			}
+
+			template <class Pred>
+			[[nodiscard]] size_t partition_point(const K*, const size_t n, Pred pred) const
+			{
+				if (n == 0) return 0;
+
+				// Descendants this many levels down share a cache line
+				constexpr size_t block = std::bit_floor(std::max<size_t>(64 / sizeof(K), 1));
+				const K* const keys = keys_.data();
+				size_t k = 1;
+				while (k <= n)
+				{
+					OSTL_PREFETCH(keys + std::min(block * k, n) - 1);
+					k = 2 * k + pred(keys[k - 1]);
+				}
+
+				// The answer is the last node where the path went left: drop the right turns below it and that left turn
+				k >>= std::countr_one(k) + 1;
+				return ranks_[k];
+			}
+
+		private:
+			size_t fill(const size_t k, size_t i, const size_t n)
+			{
+				if (k > n) return i;
+				i = fill(2 * k, i, n);
+				ranks_[k] = i++;
+				return fill(2 * k + 1, i, n);
+			}
+
+			vector<K, aligned_allocator<K>> keys_;
+			vector<size_t> ranks_;
+		};
+
+		// operator-> for iterators whose reference is a proxy
+		template <class Ref>
+		struct ArrowProxy
+		{
+			Ref ref;
+			Ref* operator->() noexcept { return &ref; }
+		};
+	}
+}
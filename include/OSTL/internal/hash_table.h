@@ -0,0 +1,701 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "../functional.h"
+#include "alloc_traits.h"
+#include "config.h"
+
+#ifdef OSTL_X64
+#include <emmintrin.h>
+#endif
+
+// Swiss-table style open addressing: slots sit in one array, and a parallel array of control bytes tells
+// for each slot whether it is empty, deleted (a tombstone) or full, and for full ones holds 7 bits of the
+// key's hash. Lookups compare 16 control bytes at once and only touch slots whose bits match.
+namespace ostl::internal
+{
+	using Ctrl = int8_t;
+
+	inline constexpr Ctrl ctrl_empty = -128;
+	inline constexpr Ctrl ctrl_deleted = -2;
+	inline constexpr Ctrl ctrl_sentinel = -1;
+
+	inline constexpr size_t group_width = 16;
+
+	// What an empty table points at: probes stop at once, iteration ends at the sentinel
+	alignas(group_width) inline constexpr Ctrl empty_group[group_width] = {
+		ctrl_sentinel, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+		ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+	};
+
+	// 16 consecutive control bytes. Each match returns a mask with bit i set for byte i.
+	class Group
+	{
+	public:
+		explicit Group(const Ctrl* ctrl) noexcept
+		{
+#ifdef OSTL_X64
+			ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+			std::memcpy(ctrl_, ctrl, group_width);
+#endif
+		}
+
+		[[nodiscard]] uint32_t match(const Ctrl h2) const noexcept
+		{
+#ifdef OSTL_X64
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+#else
+			return Scan([h2](const Ctrl c) { return c == h2; });
+#endif
+		}
+
+		[[nodiscard]] uint32_t match_empty() const noexcept
+		{
+#ifdef OSTL_X64
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl_empty), ctrl_)));
+#else
+			return Scan([](const Ctrl c) { return c == ctrl_empty; });
+#endif
+		}
+
+		// Empty and deleted are the only control bytes below the sentinel
+		[[nodiscard]] uint32_t match_empty_or_deleted() const noexcept
+		{
+#ifdef OSTL_X64
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl_)));
+#else
+			return Scan([](const Ctrl c) { return c < ctrl_sentinel; });
+#endif
+		}
+
+	private:
+#ifdef OSTL_X64
+		__m128i ctrl_;
+#else
+		template <class Pred>
+		[[nodiscard]] uint32_t Scan(Pred pred) const noexcept
+		{
+			uint32_t mask = 0;
+			for (size_t i = 0; i < group_width; ++i)
+				if (pred(ctrl_[i])) mask |= uint32_t{1} << i;
+			return mask;
+		}
+
+		Ctrl ctrl_[group_width];
+#endif
+	};
+
+	// Spreads the entropy of weak hashes (std::hash<int> is the identity) over all bits
+	[[nodiscard]] inline size_t HashMix(size_t h) noexcept
+	{
+		h ^= h >> 32;
+		h *= 0x9E37'79B9'7F4A'7C15;
+		h ^= h >> 29;
+		return h;
+	}
+
+	[[nodiscard]] inline size_t H1(const size_t hash) noexcept { return hash >> 7; }
+	[[nodiscard]] inline Ctrl H2(const size_t hash) noexcept { return static_cast<Ctrl>(hash & 0x7F); }
+
+	// Set: the value is the key
+	template <class K>
+	struct SetPolicy
+	{
+		using key_type = K;
+		using value_type = K;
+		static constexpr bool is_set = true;
+
+		[[nodiscard]] static const K& Key(const value_type& v) noexcept { return v; }
+	};
+
+	template <class K, class V>
+	struct MapPolicy
+	{
+		using key_type = K;
+		using value_type = std::pair<const K, V>;
+		static constexpr bool is_set = false;
+
+		[[nodiscard]] static const K& Key(const value_type& v) noexcept { return v.first; }
+	};
+
+	// Capacity is always 2^k - 1 (or 0), so the probe position wraps with a mask. The control array has
+	// capacity + group_width bytes: the sentinel at [capacity], then clones of the first group_width - 1
+	// bytes, so that a group can be loaded from any position without wrapping. Tables stay at most 7/8 full.
+	template <class Policy, class Hash, class Eq, class Alloc>
+	class HashTable
+	{
+		using alloc_traits = std::allocator_traits<Alloc>;
+		using ctrl_alloc = typename alloc_traits::template rebind_alloc<Ctrl>;
+
+	public:
+		using key_type = typename Policy::key_type;
+		using value_type = typename Policy::value_type;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using hasher = Hash;
+		using key_equal = Eq;
+		using allocator_type = Alloc;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using pointer = typename alloc_traits::pointer;
+		using const_pointer = typename alloc_traits::const_pointer;
+
+		static_assert(std::is_same_v<typename alloc_traits::value_type, value_type>);
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename HashTable::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+			const_iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return *slot_; }
+			[[nodiscard]] pointer operator->() const { return slot_; }
+
+			const_iterator& operator++()
+			{
+				++ctrl_;
+				++slot_;
+				skip_empty_or_deleted();
+				return *this;
+			}
+
+			const_iterator operator++(int)
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const { return ctrl_ == rhs.ctrl_; }
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+		protected:
+			friend HashTable;
+
+			const_iterator(const Ctrl* ctrl, typename HashTable::pointer slot) : ctrl_{ctrl}, slot_{slot}
+			{
+			}
+
+			// Whole runs of free slots are skipped a group at a time; the sentinel stops the scan
+			void skip_empty_or_deleted()
+			{
+				while (*ctrl_ < ctrl_sentinel)
+				{
+					const auto n = std::countr_one(Group{ctrl_}.match_empty_or_deleted());
+					ctrl_ += n;
+					slot_ += n;
+				}
+			}
+
+			const Ctrl* ctrl_ = nullptr;
+			typename HashTable::pointer slot_ = nullptr;
+		};
+
+		class mutable_iterator : public const_iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename HashTable::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = value_type*;
+			using reference = value_type&;
+
+			mutable_iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return *this->slot_; }
+			[[nodiscard]] pointer operator->() const { return this->slot_; }
+
+			mutable_iterator& operator++()
+			{
+				const_iterator::operator++();
+				return *this;
+			}
+
+			mutable_iterator operator++(int)
+			{
+				mutable_iterator it = *this;
+				++*this;
+				return it;
+			}
+
+		private:
+			friend HashTable;
+
+			mutable_iterator(const Ctrl* ctrl, typename HashTable::pointer slot) : const_iterator{ctrl, slot}
+			{
+			}
+		};
+
+		// Set elements are keys, so sets only hand out const access
+		using iterator = std::conditional_t<Policy::is_set, const_iterator, mutable_iterator>;
+
+		HashTable() = default;
+
+		explicit HashTable(const size_type bucket_count, const Hash& hash = Hash{}, const Eq& eq = Eq{}, const Alloc& alloc = Alloc{})
+			: hash_{hash}, eq_{eq}, alloc_{alloc}
+		{
+			reserve(bucket_count);
+		}
+
+		explicit HashTable(const Alloc& alloc) : alloc_{alloc}
+		{
+		}
+
+		HashTable(const HashTable& x)
+			: hash_{x.hash_}, eq_{x.eq_}, alloc_{alloc_traits::select_on_container_copy_construction(x.alloc_)}
+		{
+			insert_all(x);
+		}
+
+		HashTable(HashTable&& x) noexcept
+			: ctrl_{std::exchange(x.ctrl_, const_cast<Ctrl*>(empty_group))}, slots_{std::exchange(x.slots_, nullptr)},
+			  capacity_{std::exchange(x.capacity_, 0)}, size_{std::exchange(x.size_, 0)},
+			  growth_left_{std::exchange(x.growth_left_, 0)}, hash_{x.hash_}, eq_{x.eq_}, alloc_{std::move(x.alloc_)}
+		{
+		}
+
+		~HashTable()
+		{
+			destroy_all();
+			deallocate();
+		}
+
+		HashTable& operator=(const HashTable& x)
+		{
+			if (this == &x) return *this;
+			clear();
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+			{
+				// Slots must go back to the allocator that made them
+				if (alloc_ != x.alloc_) deallocate();
+				alloc_ = x.alloc_;
+			}
+			hash_ = x.hash_;
+			eq_ = x.eq_;
+			insert_all(x);
+			return *this;
+		}
+
+		HashTable& operator=(HashTable&& x)
+		noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+		{
+			if (this == &x) return *this;
+			if constexpr (!alloc_traits::propagate_on_container_move_assignment::value && !alloc_traits::is_always_equal::value)
+			{
+				if (alloc_ != x.alloc_)
+				{
+					clear();
+					hash_ = x.hash_;
+					eq_ = x.eq_;
+					insert_all(x);
+					return *this;
+				}
+			}
+
+			destroy_all();
+			deallocate();
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) alloc_ = std::move(x.alloc_);
+			ctrl_ = std::exchange(x.ctrl_, const_cast<Ctrl*>(empty_group));
+			slots_ = std::exchange(x.slots_, nullptr);
+			capacity_ = std::exchange(x.capacity_, 0);
+			size_ = std::exchange(x.size_, 0);
+			growth_left_ = std::exchange(x.growth_left_, 0);
+			hash_ = x.hash_;
+			eq_ = x.eq_;
+			return *this;
+		}
+
+		[[nodiscard]] iterator begin() noexcept
+		{
+			iterator it{ctrl_, slots_};
+			it.skip_empty_or_deleted();
+			return it;
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept { return const_cast<HashTable&>(*this).begin(); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] iterator end() noexcept { return {ctrl_ + capacity_, slots_ + capacity_}; }
+		[[nodiscard]] const_iterator end() const noexcept { return const_cast<HashTable&>(*this).end(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+		[[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+		[[nodiscard]] static size_type max_size() noexcept { return std::numeric_limits<difference_type>::max() / (sizeof(value_type) + 1); }
+
+		[[nodiscard]] hasher hash_function() const { return hash_; }
+		[[nodiscard]] key_equal key_eq() const { return eq_; }
+		[[nodiscard]] allocator_type get_allocator() const noexcept { return alloc_; }
+
+		[[nodiscard]] float load_factor() const noexcept { return capacity_ ? static_cast<float>(size_) / capacity_ : 0.f; }
+		[[nodiscard]] static float max_load_factor() noexcept { return 7.f / 8; }
+
+		// Destroys the elements; keeps the slots
+		void clear() noexcept
+		{
+			destroy_all();
+			reset_ctrl();
+		}
+
+		// Makes room for n elements without rehashing
+		void reserve(const size_type n)
+		{
+			if (n > size_ + growth_left_) resize(NormalizeCapacity(GrowthToCapacity(n)));
+		}
+
+		void rehash(const size_type n)
+		{
+			const size_type cap = NormalizeCapacity(std::max(n, GrowthToCapacity(size_)));
+			if (n == 0 && size_ == 0)
+			{
+				destroy_all();
+				deallocate();
+			}
+			else if (cap != capacity_ || growth_left_ != CapacityToGrowth(capacity_) - size_)
+			{
+				resize(cap);
+			}
+		}
+
+		std::pair<iterator, bool> insert(const value_type& v) { return emplace_key(Policy::Key(v), v); }
+		std::pair<iterator, bool> insert(value_type&& v) { return emplace_key(Policy::Key(v), std::move(v)); }
+
+		template <class InputIt>
+		void insert(InputIt first, const InputIt last)
+		{
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+				reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+			for (; first != last; ++first) insert(*first);
+		}
+
+		void insert(const std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+		// The element is built first to find its key; try_emplace avoids that for maps
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			value_type v(std::forward<Args>(args)...);
+			return emplace_key(Policy::Key(v), std::move(v));
+		}
+
+		iterator erase(const_iterator position)
+		{
+			erase_at(static_cast<size_type>(position.ctrl_ - ctrl_));
+			++position;
+			return {position.ctrl_, position.slot_};
+		}
+
+		iterator erase(const_iterator first, const const_iterator last)
+		{
+			while (first != last) first = erase(first);
+			return {first.ctrl_, first.slot_};
+		}
+
+		template <class K = key_type, class = std::enable_if_t<!std::is_convertible_v<const K&, const_iterator>>>
+		size_type erase(const K& key)
+		{
+			const size_type i = find_index(key, hash_key(key));
+			if (i == npos) return 0;
+			erase_at(i);
+			return 1;
+		}
+
+		template <class K = key_type>
+		[[nodiscard]] iterator find(const K& key)
+		{
+			const size_type i = find_index(key, hash_key(key));
+			return i == npos ? end() : iterator{ctrl_ + i, slots_ + i};
+		}
+
+		template <class K = key_type>
+		[[nodiscard]] const_iterator find(const K& key) const { return const_cast<HashTable&>(*this).find(key); }
+
+		template <class K = key_type>
+		[[nodiscard]] bool contains(const K& key) const { return find_index(key, hash_key(key)) != npos; }
+
+		template <class K = key_type>
+		[[nodiscard]] size_type count(const K& key) const { return contains(key); }
+
+		template <class K = key_type>
+		[[nodiscard]] std::pair<iterator, iterator> equal_range(const K& key)
+		{
+			const auto it = find(key);
+			if (it == end()) return {it, it};
+			return {it, std::next(it)};
+		}
+
+		void swap(HashTable& x) noexcept
+		{
+			using std::swap;
+			swap(ctrl_, x.ctrl_);
+			swap(slots_, x.slots_);
+			swap(capacity_, x.capacity_);
+			swap(size_, x.size_);
+			swap(growth_left_, x.growth_left_);
+			swap(hash_, x.hash_);
+			swap(eq_, x.eq_);
+			if constexpr (alloc_traits::propagate_on_container_swap::value) swap(alloc_, x.alloc_);
+		}
+
+	protected:
+		static constexpr size_type npos = size_type(-1);
+
+		// Heterogeneous keys are only hashed and compared as they are when both functors are transparent
+		template <class K>
+		using key_arg = std::conditional_t<IsTransparent<Hash> && IsTransparent<Eq>, K, key_type>;
+
+		template <class K>
+		[[nodiscard]] size_t hash_key(const K& key) const
+		{
+			return HashMix(hash_(static_cast<const key_arg<K>&>(key)));
+		}
+
+		template <class K>
+		[[nodiscard]] size_type find_index(const K& key, const size_t hash) const
+		{
+			const key_arg<K>& k = key;
+			size_type pos = H1(hash) & capacity_, step = 0;
+			while (true)
+			{
+				const Group g{ctrl_ + pos};
+				for (auto m = g.match(H2(hash)); m; m &= m - 1)
+				{
+					const size_type i = (pos + std::countr_zero(m)) & capacity_;
+					if (eq_(Policy::Key(slots_[i]), k)) return i;
+				}
+				if (g.match_empty()) return npos;
+				step += group_width;
+				pos = (pos + step) & capacity_;
+			}
+		}
+
+		// Inserts v unless an element with key is present. key may refer into args.
+		template <class K, class... Args>
+		std::pair<iterator, bool> emplace_key(const K& key, Args&&... args)
+		{
+			const size_t hash = hash_key(key);
+			if (const size_type i = find_index(key, hash); i != npos) return {iterator{ctrl_ + i, slots_ + i}, false};
+			return {insert_unique(hash, std::forward<Args>(args)...), true};
+		}
+
+		// Inserts x's elements, which are known to be absent, moving them out unless X is const
+		template <class X>
+		void insert_all(X& x)
+		{
+			reserve(x.size_);
+			for (auto& v : x)
+			{
+				if constexpr (std::is_const_v<X>) insert_unique(hash_key(Policy::Key(v)), v);
+				else insert_unique(hash_key(Policy::Key(v)), std::move(v));
+			}
+		}
+
+		// Constructs a new element whose key is known to be absent
+		template <class... Args>
+		iterator insert_unique(const size_t hash, Args&&... args)
+		{
+			size_type i = find_first_non_full(hash);
+			if (growth_left_ == 0 && ctrl_[i] != ctrl_deleted)
+			{
+				grow();
+				i = find_first_non_full(hash);
+			}
+			alloc_traits::construct(alloc_, slots_ + i, std::forward<Args>(args)...);
+			growth_left_ -= ctrl_[i] == ctrl_empty;
+			set_ctrl(i, H2(hash));
+			++size_;
+			return {ctrl_ + i, slots_ + i};
+		}
+
+		[[nodiscard]] size_type find_first_non_full(const size_t hash) const noexcept
+		{
+			size_type pos = H1(hash) & capacity_, step = 0;
+			while (true)
+			{
+				if (const auto m = Group{ctrl_ + pos}.match_empty_or_deleted())
+					return (pos + std::countr_zero(m)) & capacity_;
+				step += group_width;
+				pos = (pos + step) & capacity_;
+			}
+		}
+
+		// A slot can go back to empty, rather than becoming a tombstone, when no group containing it was ever
+		// full: then no probe sequence has passed over it
+		void erase_at(const size_type i)
+		{
+			alloc_traits::destroy(alloc_, slots_ + i);
+			--size_;
+
+			const auto before = Group{ctrl_ + ((i - group_width) & capacity_)}.match_empty();
+			const auto after = Group{ctrl_ + i}.match_empty();
+			const bool never_full = before && after
+				&& static_cast<size_t>(std::countr_zero(after) + std::countl_zero(static_cast<uint16_t>(before))) < group_width;
+
+			set_ctrl(i, never_full ? ctrl_empty : ctrl_deleted);
+			growth_left_ += never_full;
+		}
+
+	private:
+		[[nodiscard]] static constexpr size_type NormalizeCapacity(const size_type n) noexcept
+		{
+			return n < group_width ? group_width - 1 : std::bit_ceil(n + 1) - 1;
+		}
+
+		[[nodiscard]] static constexpr size_type CapacityToGrowth(const size_type cap) noexcept { return cap - cap / 8; }
+		[[nodiscard]] static constexpr size_type GrowthToCapacity(const size_type n) noexcept { return n ? n + (n - 1) / 7 : 0; }
+
+		void set_ctrl(const size_type i, const Ctrl h) noexcept
+		{
+			ctrl_[i] = h;
+			ctrl_[((i - (group_width - 1)) & capacity_) + (group_width - 1)] = h;
+		}
+
+		void reset_ctrl() noexcept
+		{
+			if (capacity_ == 0) return;
+			std::memset(ctrl_, ctrl_empty, capacity_ + group_width);
+			ctrl_[capacity_] = ctrl_sentinel;
+			growth_left_ = CapacityToGrowth(capacity_);
+		}
+
+		// Doubles the table, or only drops tombstones when they take up much of it
+		OSTL_NOINLINE void grow()
+		{
+			if (capacity_ > group_width && size_ * 32 <= capacity_ * 25) resize(capacity_);
+			else resize(capacity_ ? capacity_ * 2 + 1 : group_width - 1);
+		}
+
+		void resize(const size_type cap)
+		{
+			if (cap > max_size()) throw std::length_error{""};
+
+			Ctrl* const old_ctrl = ctrl_;
+			const pointer old_slots = slots_;
+			const size_type old_cap = capacity_;
+
+			ctrl_alloc ca{alloc_};
+			Ctrl* const ctrl = std::allocator_traits<ctrl_alloc>::allocate(ca, cap + group_width);
+			pointer slots;
+			try
+			{
+				slots = alloc_traits::allocate(alloc_, cap);
+			}
+			catch (...)
+			{
+				std::allocator_traits<ctrl_alloc>::deallocate(ca, ctrl, cap + group_width);
+				throw;
+			}
+
+			ctrl_ = ctrl;
+			slots_ = slots;
+			capacity_ = cap;
+			reset_ctrl();
+			growth_left_ -= size_;
+
+			for (size_type i = 0; i < old_cap; ++i)
+			{
+				if (old_ctrl[i] < 0) continue;
+				const size_t hash = hash_key(Policy::Key(old_slots[i]));
+				const size_type j = find_first_non_full(hash);
+				set_ctrl(j, H2(hash));
+				relocate(old_slots + i, slots_ + j);
+			}
+
+			if (old_cap)
+			{
+				std::allocator_traits<ctrl_alloc>::deallocate(ca, old_ctrl, old_cap + group_width);
+				alloc_traits::deallocate(alloc_, old_slots, old_cap);
+			}
+		}
+
+		void relocate(const pointer src, const pointer dst)
+		{
+			if constexpr (CanRelocate<value_type, Alloc>)
+			{
+				std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+			}
+			else
+			{
+				alloc_traits::construct(alloc_, dst, std::move(*src));
+				alloc_traits::destroy(alloc_, src);
+			}
+		}
+
+		void destroy_all() noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<value_type> || !IsPlainConstruct<Alloc, value_type>::value)
+			{
+				for (size_type i = 0; i < capacity_; ++i)
+					if (ctrl_[i] >= 0) alloc_traits::destroy(alloc_, slots_ + i);
+			}
+			size_ = 0;
+		}
+
+		void deallocate() noexcept
+		{
+			if (capacity_ == 0) return;
+			ctrl_alloc ca{alloc_};
+			std::allocator_traits<ctrl_alloc>::deallocate(ca, ctrl_, capacity_ + group_width);
+			alloc_traits::deallocate(alloc_, slots_, capacity_);
+			ctrl_ = const_cast<Ctrl*>(empty_group);
+			slots_ = nullptr;
+			capacity_ = 0;
+			growth_left_ = 0;
+		}
+
+		Ctrl* ctrl_ = const_cast<Ctrl*>(empty_group);
+		pointer slots_ = nullptr;
+		size_type capacity_ = 0;
+		size_type size_ = 0;
+		size_type growth_left_ = 0;
+		[[no_unique_address]] Hash hash_;
+		[[no_unique_address]] Eq eq_;
+		[[no_unique_address]] Alloc alloc_;
+	};
+
+	template <class Policy, class Hash, class Eq, class Alloc>
+	[[nodiscard]] bool operator==(const HashTable<Policy, Hash, Eq, Alloc>& lhs, const HashTable<Policy, Hash, Eq, Alloc>& rhs)
+	{
+		if (lhs.size() != rhs.size()) return false;
+		for (const auto& v : lhs)
+		{
+			const auto it = rhs.find(Policy::Key(v));
+			if (it == rhs.end() || !(*it == v)) return false;
+		}
+		return true;
+	}
+
+	template <class Policy, class Hash, class Eq, class Alloc>
+	void swap(HashTable<Policy, Hash, Eq, Alloc>& lhs, HashTable<Policy, Hash, Eq, Alloc>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	template <class Policy, class Hash, class Eq, class Alloc, class Pred>
+	size_t EraseIf(HashTable<Policy, Hash, Eq, Alloc>& c, Pred pred)
+	{
+		const size_t old = c.size();
+		for (auto it = c.begin(); it != c.end();)
+		{
+			if (pred(*it)) it = c.erase(it);
+			else ++it;
+		}
+		return old - c.size();
+	}
+}
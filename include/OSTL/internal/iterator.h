@@ -3,6 +3,9 @@
 
 namespace ostl::internal
 {
+	template <class It>
+	inline constexpr bool IsForwardIterator = std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
 	template <class V, class D, class P, class R>
 	class const_iterator
 	{
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "internal/alloc_traits.h"
+
+namespace ostl
+{
+	// Allocates straight from malloc. vector reports the block's usable size as capacity and, with
+	// growth::in_place, resizes trivially relocatable elements with realloc. Bypasses operator new, so
+	// replacements of it do not see these blocks.
+	template <class T>
+	class malloc_allocator
+	{
+		static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not align T");
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using propagate_on_container_move_assignment = std::true_type;
+		using is_always_equal = std::true_type;
+
+		malloc_allocator() noexcept = default;
+
+		template <class U>
+		malloc_allocator(const malloc_allocator<U>&) noexcept
+		{
+		}
+
+		[[nodiscard]] T* allocate(const size_t n)
+		{
+			if (n == 0) return nullptr;
+			if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length{};
+			void* const p = std::malloc(n * sizeof(T));
+			if (!p) throw std::bad_alloc{};
+			return static_cast<T*>(p);
+		}
+
+		void deallocate(T* p, size_t) noexcept { std::free(p); }
+
+		[[nodiscard]] friend bool operator==(const malloc_allocator&, const malloc_allocator&) noexcept { return true; }
+		[[nodiscard]] friend bool operator!=(const malloc_allocator&, const malloc_allocator&) noexcept { return false; }
+	};
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "internal/config.h"
+
+#ifdef OSTL_HAS_MMAP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "internal/iterator.h"
+
+namespace ostl
+{
+	namespace internal
+	{
+		// Every mapped_vector file starts with this, followed by the elements at offset 64
+		struct MappedHeader
+		{
+			static constexpr uint64_t signature = 0x4345'564D'4C54'534F; // "OSTLMVEC"
+
+			uint64_t magic;
+			uint64_t elem_size;
+			uint64_t size;
+			uint64_t reserved[5];
+		};
+
+		static_assert(sizeof(MappedHeader) == 64);
+
+		[[noreturn]] inline void ThrowErrno()
+		{
+			throw std::system_error{errno, std::generic_category()};
+		}
+	}
+
+	// A vector of trivially copyable elements that lives in a file, so loading it is a single mmap. The file
+	// holds a small header with the element count, then the elements in native layout; its length is the
+	// capacity. read_write opens or creates the file and maps it shared, so appends grow the file and every
+	// write reaches it without an explicit save. read_only maps an existing file shared and read-only, letting
+	// several processes use one copy in the page cache; its size is fixed when opened, and writing through it
+	// (including through non-const accessors) is not allowed.
+	template <class T>
+	class mapped_vector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "mapped_vector requires a trivially copyable type");
+		static_assert(alignof(T) <= sizeof(internal::MappedHeader), "mapped_vector cannot align the element type");
+
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using iterator = internal::iterator<value_type, difference_type, pointer, reference>;
+		using const_iterator = internal::const_iterator<value_type, difference_type, pointer, reference>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		enum class mode { read_only, read_write };
+
+		mapped_vector() noexcept = default;
+
+		explicit mapped_vector(const char* path, const mode m = mode::read_write) : writable_{m == mode::read_write}
+		{
+			try
+			{
+				open(path);
+			}
+			catch (...)
+			{
+				release();
+				throw;
+			}
+		}
+
+		mapped_vector(mapped_vector&& r) noexcept
+			: base_{std::exchange(r.base_, nullptr)}, length_{std::exchange(r.length_, 0)},
+			  size_{std::exchange(r.size_, 0)}, capacity_{std::exchange(r.capacity_, 0)},
+			  fd_{std::exchange(r.fd_, -1)}, writable_{r.writable_}
+		{
+		}
+
+		mapped_vector& operator=(mapped_vector&& r) noexcept
+		{
+			mapped_vector{std::move(r)}.swap(*this);
+			return *this;
+		}
+
+		~mapped_vector() { release(); }
+
+		[[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+		[[nodiscard]] bool writable() const noexcept { return writable_ && is_open(); }
+
+		[[nodiscard]] reference at(size_type n)
+		{
+			return const_cast<reference>(static_cast<const mapped_vector&>(*this).at(n));
+		}
+
+		[[nodiscard]] const_reference at(size_type n) const
+		{
+			if (n >= size_) throw std::out_of_range{""};
+			return data()[n];
+		}
+
+		[[nodiscard]] reference operator[](size_type n) { return data()[n]; }
+		[[nodiscard]] const_reference operator[](size_type n) const { return data()[n]; }
+		[[nodiscard]] reference front() { return *data(); }
+		[[nodiscard]] const_reference front() const { return *data(); }
+		[[nodiscard]] reference back() { return data()[size_ - 1]; }
+		[[nodiscard]] const_reference back() const { return data()[size_ - 1]; }
+
+		[[nodiscard]] pointer data() noexcept { return const_cast<pointer>(static_cast<const mapped_vector&>(*this).data()); }
+		[[nodiscard]] const_pointer data() const noexcept
+		{
+			return base_ ? reinterpret_cast<const_pointer>(static_cast<const char*>(base_) + sizeof(internal::MappedHeader)) : nullptr;
+		}
+
+		[[nodiscard]] iterator begin() noexcept { return iterator{data()}; }
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator{const_cast<pointer>(data())}; }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+
+		[[nodiscard]] iterator end() noexcept { return iterator{data() + size_}; }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator{const_cast<pointer>(data()) + size_}; }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{cend()}; }
+
+		[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return const_reverse_iterator{cbegin()}; }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+		[[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+
+		[[nodiscard]] static size_type max_size() noexcept
+		{
+			return (std::numeric_limits<difference_type>::max() - sizeof(internal::MappedHeader)) / sizeof(T);
+		}
+
+		// Grows the file so that it holds at least n elements
+		void reserve(const size_type n)
+		{
+			check_writable();
+			if (n > capacity_) remap(n);
+		}
+
+		// Truncates the file to the elements in use, rounded up to a whole page
+		void shrink_to_fit()
+		{
+			check_writable();
+			if (FileLength(size_) < length_) remap(size_);
+		}
+
+		void push_back(const T& value) { emplace_back(value); }
+
+		template <class... Args>
+		reference emplace_back(Args&&... args)
+		{
+			check_writable();
+			// Built first, since the arguments may refer to elements that growing would unmap
+			const T value(std::forward<Args>(args)...);
+			if (size_ == capacity_) grow(size_ + 1);
+			const auto p = data() + size_;
+			std::memcpy(static_cast<void*>(p), &value, sizeof(T));
+			set_size(size_ + 1);
+			return *p;
+		}
+
+		// The range must not come from *this, which growing may move
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>>>
+		void append(InputIt first, const InputIt last)
+		{
+			check_writable();
+			if constexpr (internal::IsForwardIterator<InputIt>)
+			{
+				const auto n = static_cast<size_type>(std::distance(first, last));
+				if (size_ + n > capacity_) grow(size_ + n);
+				std::uninitialized_copy(first, last, data() + size_);
+				set_size(size_ + n);
+			}
+			else
+			{
+				for (; first != last; ++first) emplace_back(*first);
+			}
+		}
+
+		template <class R>
+		void append_range(R&& rg)
+		{
+			append(std::ranges::begin(rg), std::ranges::end(rg));
+		}
+
+		void pop_back()
+		{
+			check_writable();
+			set_size(size_ - 1);
+		}
+
+		void resize(const size_type n) { resize(n, T{}); }
+
+		void resize(const size_type n, const T value)
+		{
+			check_writable();
+			if (n > capacity_) grow(n);
+			if (n > size_) std::uninitialized_fill(data() + size_, data() + n, value);
+			set_size(n);
+		}
+
+		void clear()
+		{
+			check_writable();
+			set_size(0);
+		}
+
+		// Writes dirty pages back to the file; with wait = false the write-back is only scheduled
+		void sync(const bool wait = true) const
+		{
+			if (writable() && ::msync(base_, length_, wait ? MS_SYNC : MS_ASYNC) != 0) internal::ThrowErrno();
+		}
+
+		void swap(mapped_vector& r) noexcept
+		{
+			using std::swap;
+			swap(base_, r.base_);
+			swap(length_, r.length_);
+			swap(size_, r.size_);
+			swap(capacity_, r.capacity_);
+			swap(fd_, r.fd_);
+			swap(writable_, r.writable_);
+		}
+
+	private:
+		[[nodiscard]] internal::MappedHeader& header() const noexcept { return *static_cast<internal::MappedHeader*>(base_); }
+
+		// File length for n elements: whole pages, since that is what gets mapped anyway
+		[[nodiscard]] static size_t FileLength(const size_type n)
+		{
+			if (n > max_size()) throw std::length_error{""};
+			const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+			return (sizeof(internal::MappedHeader) + n * sizeof(T) + (page - 1)) / page * page;
+		}
+
+		void open(const char* path)
+		{
+			fd_ = ::open(path, writable_ ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+			if (fd_ < 0) internal::ThrowErrno();
+
+			struct stat st;
+			if (::fstat(fd_, &st) != 0) internal::ThrowErrno();
+			const auto length = static_cast<size_t>(st.st_size);
+
+			if (length == 0 && writable_)
+			{
+				remap(0);
+				header() = {internal::MappedHeader::signature, sizeof(T), 0, {}};
+				return;
+			}
+
+			if (length < sizeof(internal::MappedHeader)) throw std::invalid_argument{""};
+			map(length);
+			const auto& h = header();
+			if (h.magic != internal::MappedHeader::signature || h.elem_size != sizeof(T) || h.size > capacity_)
+				throw std::invalid_argument{""};
+			size_ = h.size;
+		}
+
+		void map(const size_t length)
+		{
+			const int prot = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+			void* const p = ::mmap(nullptr, length, prot, MAP_SHARED, fd_, 0);
+			if (p == MAP_FAILED) internal::ThrowErrno();
+			base_ = p;
+			length_ = length;
+			capacity_ = (length - sizeof(internal::MappedHeader)) / sizeof(T);
+		}
+
+		// Resizes the file to FileLength(n) and maps all of it
+		void remap(const size_type n)
+		{
+			const size_t length = FileLength(n);
+			if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) internal::ThrowErrno();
+			if (!base_) return map(length);
+
+#ifdef MREMAP_MAYMOVE
+			void* const p = ::mremap(base_, length_, length, MREMAP_MAYMOVE);
+			if (p == MAP_FAILED) internal::ThrowErrno();
+			base_ = p;
+			length_ = length;
+			capacity_ = (length - sizeof(internal::MappedHeader)) / sizeof(T);
+#else
+			::munmap(base_, length_);
+			base_ = nullptr;
+			map(length);
+#endif
+		}
+
+		OSTL_NOINLINE void grow(const size_type required)
+		{
+			remap(std::max(required, capacity_ + capacity_ / 2));
+		}
+
+		void set_size(const size_type n) noexcept
+		{
+			size_ = n;
+			header().size = n;
+		}
+
+		void check_writable() const
+		{
+			if (!writable()) throw std::logic_error{""};
+		}
+
+		void release() noexcept
+		{
+			if (base_) ::munmap(base_, length_);
+			if (fd_ >= 0) ::close(fd_);
+			base_ = nullptr;
+			fd_ = -1;
+		}
+
+		void* base_ = nullptr;
+		size_t length_ = 0;
+		size_type size_ = 0;
+		size_type capacity_ = 0;
+		int fd_ = -1;
+		bool writable_ = false;
+	};
+
+	template <class T>
+	void swap(mapped_vector<T>& a, mapped_vector<T>& b) noexcept
+	{
+		a.swap(b);
+	}
+}
+
+#endif
@@ -0,0 +1,530 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+
+// Memory resources for request-scoped containers: allocate from them through ostl::pmr::vector,
+// ostl::pmr::basic_string, etc. and drop everything at once with release() or the destructor.
+namespace ostl::pmr
+{
+	// Bump allocator: deallocate is a no-op and memory only comes back on release(). Upstream chunks
+	// grow geometrically, so a request that allocates n bytes costs O(log n) upstream calls.
+	class monotonic_buffer_resource : public std::pmr::memory_resource
+	{
+	public:
+		monotonic_buffer_resource() noexcept : monotonic_buffer_resource{std::pmr::get_default_resource()}
+		{
+		}
+
+		explicit monotonic_buffer_resource(std::pmr::memory_resource* upstream) noexcept : upstream_{upstream}
+		{
+		}
+
+		explicit monotonic_buffer_resource(const size_t initial_size,
+		                                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: upstream_{upstream}, next_size_{std::max(initial_size, min_chunk)}
+		{
+		}
+
+		// Serves allocations from buffer until it runs out; buffer must outlive the resource
+		monotonic_buffer_resource(void* buffer, const size_t size,
+		                          std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: upstream_{upstream}, initial_{static_cast<char*>(buffer)}, initial_size_{size},
+			  cur_{initial_}, end_{initial_ + size}, next_size_{std::max(size * 2, min_chunk)}
+		{
+		}
+
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+		monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+		~monotonic_buffer_resource() override { release(); }
+
+		// Frees every upstream chunk and starts over from the initial buffer
+		void release() noexcept
+		{
+			while (chunks_)
+			{
+				Chunk* const next = chunks_->next;
+				upstream_->deallocate(chunks_, chunks_->bytes, alignof(std::max_align_t));
+				chunks_ = next;
+			}
+			cur_ = initial_;
+			end_ = initial_ + initial_size_;
+		}
+
+		[[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+	protected:
+		void* do_allocate(const size_t bytes, const size_t align) override
+		{
+			if (void* p = bump(bytes, align)) return p;
+
+			if (bytes > max_chunk - sizeof(Chunk) - align) throw std::bad_alloc{};
+			const size_t need = sizeof(Chunk) + bytes + align;
+			size_t size = next_size_;
+			while (size < need) size = Grow(size);
+
+			void* const raw = upstream_->allocate(size, alignof(std::max_align_t));
+			chunks_ = ::new(raw) Chunk{chunks_, size};
+			cur_ = static_cast<char*>(raw) + sizeof(Chunk);
+			end_ = static_cast<char*>(raw) + size;
+			next_size_ = Grow(size);
+			return bump(bytes, align);
+		}
+
+		void do_deallocate(void*, size_t, size_t) override
+		{
+		}
+
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+	private:
+		struct Chunk
+		{
+			Chunk* next;
+			size_t bytes;
+		};
+
+		static constexpr size_t min_chunk = 1024;
+		static constexpr size_t max_chunk = size_t(-1) / 2;
+
+		[[nodiscard]] static constexpr size_t Grow(const size_t size) noexcept
+		{
+			return size <= max_chunk / 2 ? size * 2 : max_chunk;
+		}
+
+		[[nodiscard]] void* bump(const size_t bytes, const size_t align) noexcept
+		{
+			if (!cur_) return nullptr;
+			const auto p = (reinterpret_cast<uintptr_t>(cur_) + (align - 1)) & ~uintptr_t(align - 1);
+			if (p > reinterpret_cast<uintptr_t>(end_) || bytes > reinterpret_cast<uintptr_t>(end_) - p) return nullptr;
+			cur_ = reinterpret_cast<char*>(p + bytes);
+			return reinterpret_cast<void*>(p);
+		}
+
+		std::pmr::memory_resource* upstream_;
+		char* initial_ = nullptr;
+		size_t initial_size_ = 0;
+		char* cur_ = nullptr;
+		char* end_ = nullptr;
+		size_t next_size_ = min_chunk;
+		Chunk* chunks_ = nullptr;
+	};
+}
+
+namespace ostl::internal
+{
+	// Pools hand out power-of-two blocks from 8 bytes up to 64 KiB
+	inline constexpr size_t min_pool_block = 8;
+	inline constexpr size_t max_pool_classes = 14;
+
+	[[nodiscard]] constexpr size_t PoolClass(const size_t size) noexcept
+	{
+		return std::bit_width(std::max(size, min_pool_block) - 1) - 3;
+	}
+
+	[[nodiscard]] constexpr size_t PoolBlock(const size_t cls) noexcept { return min_pool_block << cls; }
+
+	[[nodiscard]] inline std::pmr::pool_options NormalizePoolOptions(std::pmr::pool_options o) noexcept
+	{
+		const size_t largest = PoolBlock(max_pool_classes - 1);
+		o.largest_required_pool_block = o.largest_required_pool_block
+			? std::bit_ceil(std::clamp(o.largest_required_pool_block, min_pool_block, largest)) : 4096;
+		o.max_blocks_per_chunk = o.max_blocks_per_chunk ? std::min<size_t>(o.max_blocks_per_chunk, 1 << 20) : 1024;
+		return o;
+	}
+
+	// Free list of one block size, refilled from upstream chunks that double up to max_blocks blocks
+	class PoolBin
+	{
+	public:
+		[[nodiscard]] void* allocate(std::pmr::memory_resource* upstream, const size_t block, const size_t max_blocks)
+		{
+			if (free_) return pop();
+			if (cur_ == end_) grow(upstream, block, max_blocks);
+			void* const p = cur_;
+			cur_ += block;
+			return p;
+		}
+
+		// Takes a block from the free list or the current chunk without going upstream, or null
+		[[nodiscard]] void* try_allocate(const size_t block) noexcept
+		{
+			if (free_) return pop();
+			if (cur_ == end_) return nullptr;
+			void* const p = cur_;
+			cur_ += block;
+			return p;
+		}
+
+		void deallocate(void* p) noexcept
+		{
+			*static_cast<void**>(p) = free_;
+			free_ = p;
+		}
+
+		void release(std::pmr::memory_resource* upstream, const size_t block) noexcept
+		{
+			while (chunks_)
+			{
+				Chunk* const next = chunks_->next;
+				const size_t bytes = chunks_->blocks * block;
+				upstream->deallocate(reinterpret_cast<char*>(chunks_) - bytes, bytes + sizeof(Chunk), chunk_align(block));
+				chunks_ = next;
+			}
+			free_ = nullptr;
+			cur_ = end_ = nullptr;
+			next_blocks_ = 0;
+		}
+
+	private:
+		struct Chunk
+		{
+			Chunk* next;
+			size_t blocks;
+		};
+
+		[[nodiscard]] static constexpr size_t chunk_align(const size_t block) noexcept
+		{
+			return std::max(block, alignof(Chunk));
+		}
+
+		[[nodiscard]] void* pop() noexcept
+		{
+			void* const p = free_;
+			free_ = *static_cast<void**>(p);
+			return p;
+		}
+
+		// The chunk header sits after the blocks so the first block keeps the chunk's alignment
+		void grow(std::pmr::memory_resource* upstream, const size_t block, const size_t max_blocks)
+		{
+			const size_t n = next_blocks_ ? next_blocks_ : std::clamp<size_t>(4096 / block, 1, max_blocks);
+			const auto p = static_cast<char*>(upstream->allocate(n * block + sizeof(Chunk), chunk_align(block)));
+			chunks_ = ::new(p + n * block) Chunk{chunks_, n};
+			cur_ = p;
+			end_ = p + n * block;
+			next_blocks_ = std::min(n * 2, max_blocks);
+		}
+
+		void* free_ = nullptr;
+		char* cur_ = nullptr;
+		char* end_ = nullptr;
+		Chunk* chunks_ = nullptr;
+		size_t next_blocks_ = 0;
+	};
+
+	// Allocations too big for any pool go straight upstream, linked so that release() can find them
+	class LargeBlocks
+	{
+	public:
+		[[nodiscard]] void* allocate(std::pmr::memory_resource* upstream, const size_t bytes, const size_t align)
+		{
+			const size_t pad = padding(align);
+			const auto raw = static_cast<char*>(upstream->allocate(bytes + pad, std::max(align, alignof(Node))));
+			const auto node = ::new(raw + pad - sizeof(Node)) Node{nullptr, head_, bytes, align};
+			if (head_) head_->prev = node;
+			head_ = node;
+			return raw + pad;
+		}
+
+		void deallocate(std::pmr::memory_resource* upstream, void* p, const size_t bytes, const size_t align) noexcept
+		{
+			const auto node = reinterpret_cast<Node*>(static_cast<char*>(p) - sizeof(Node));
+			if (node->prev) node->prev->next = node->next;
+			else head_ = node->next;
+			if (node->next) node->next->prev = node->prev;
+			const size_t pad = padding(align);
+			upstream->deallocate(static_cast<char*>(p) - pad, bytes + pad, std::max(align, alignof(Node)));
+		}
+
+		void release(std::pmr::memory_resource* upstream) noexcept
+		{
+			while (head_)
+			{
+				Node* const next = head_->next;
+				const size_t pad = padding(head_->align);
+				upstream->deallocate(reinterpret_cast<char*>(head_ + 1) - pad, head_->bytes + pad,
+				                     std::max(head_->align, alignof(Node)));
+				head_ = next;
+			}
+		}
+
+	private:
+		struct Node
+		{
+			Node* prev;
+			Node* next;
+			size_t bytes;
+			size_t align;
+		};
+
+		[[nodiscard]] static constexpr size_t padding(const size_t align) noexcept
+		{
+			return (sizeof(Node) + (align - 1)) & ~(align - 1);
+		}
+
+		Node* head_ = nullptr;
+	};
+}
+
+namespace ostl::pmr
+{
+	// Size-class pools for a single thread. Freed blocks are reused by later allocations of the same
+	// class; everything, including blocks larger than the biggest pool, goes back upstream on release().
+	class unsynchronized_pool_resource : public std::pmr::memory_resource
+	{
+	public:
+		unsynchronized_pool_resource() : unsynchronized_pool_resource{std::pmr::pool_options{}}
+		{
+		}
+
+		explicit unsynchronized_pool_resource(std::pmr::memory_resource* upstream)
+			: unsynchronized_pool_resource{std::pmr::pool_options{}, upstream}
+		{
+		}
+
+		explicit unsynchronized_pool_resource(const std::pmr::pool_options& opts,
+		                                      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+			: upstream_{upstream}, opts_{internal::NormalizePoolOptions(opts)}
+		{
+		}
+
+		unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+		unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+		~unsynchronized_pool_resource() override { release(); }
+
+		void release() noexcept
+		{
+			for (size_t c = 0; c < internal::max_pool_classes; ++c) bins_[c].release(upstream_, internal::PoolBlock(c));
+			large_.release(upstream_);
+		}
+
+		[[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+		[[nodiscard]] std::pmr::pool_options options() const noexcept { return opts_; }
+
+	protected:
+		void* do_allocate(const size_t bytes, const size_t align) override
+		{
+			const size_t size = std::max(bytes, align);
+			if (size > opts_.largest_required_pool_block) return large_.allocate(upstream_, bytes, align);
+			const size_t c = internal::PoolClass(size);
+			return bins_[c].allocate(upstream_, internal::PoolBlock(c), opts_.max_blocks_per_chunk);
+		}
+
+		void do_deallocate(void* p, const size_t bytes, const size_t align) override
+		{
+			const size_t size = std::max(bytes, align);
+			if (size > opts_.largest_required_pool_block) large_.deallocate(upstream_, p, bytes, align);
+			else bins_[internal::PoolClass(size)].deallocate(p);
+		}
+
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+	private:
+		std::pmr::memory_resource* upstream_;
+		std::pmr::pool_options opts_;
+		internal::PoolBin bins_[internal::max_pool_classes];
+		internal::LargeBlocks large_;
+	};
+
+	// Thread-safe pools without a global lock: each size class has its own mutex, and every thread keeps
+	// a small magazine of free blocks per class that serves most allocations and deallocations without
+	// locking. A thread caches blocks of one resource at a time; switching resources or exiting hands
+	// the cached blocks back to their pools.
+	class synchronized_pool_resource : public std::pmr::memory_resource
+	{
+	public:
+		synchronized_pool_resource() : synchronized_pool_resource{std::pmr::pool_options{}}
+		{
+		}
+
+		explicit synchronized_pool_resource(std::pmr::memory_resource* upstream)
+			: synchronized_pool_resource{std::pmr::pool_options{}, upstream}
+		{
+		}
+
+		explicit synchronized_pool_resource(const std::pmr::pool_options& opts,
+		                                    std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+			: core_{std::make_shared<Core>(upstream, internal::NormalizePoolOptions(opts))}
+		{
+		}
+
+		synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+		synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+		// Threads flushing their magazines may still hold the pools; the last of them frees the chunks
+		~synchronized_pool_resource() override = default;
+
+		// Must not run concurrently with allocations. Blocks cached by other threads are discarded.
+		void release() noexcept { core_->release(); }
+
+		[[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept { return core_->upstream; }
+		[[nodiscard]] std::pmr::pool_options options() const noexcept { return core_->opts; }
+
+	protected:
+		void* do_allocate(const size_t bytes, const size_t align) override
+		{
+			const size_t size = std::max(bytes, align);
+			if (size > core_->opts.largest_required_pool_block)
+			{
+				std::lock_guard lock{core_->large_mutex};
+				return core_->large.allocate(core_->upstream, bytes, align);
+			}
+
+			const size_t c = internal::PoolClass(size);
+			Magazine& m = magazine();
+			if (m.epoch == core_->epoch.load(std::memory_order_relaxed) && m.count[c]) return m.pop(c);
+
+			adopt(m);
+			const size_t block = internal::PoolBlock(c);
+			Bin& bin = core_->bins[c];
+			std::lock_guard lock{bin.mutex};
+			void* const p = bin.pool.allocate(core_->upstream, block, core_->opts.max_blocks_per_chunk);
+			while (m.count[c] < refill)
+			{
+				void* const q = bin.pool.try_allocate(block);
+				if (!q) break;
+				m.push(c, q);
+			}
+			return p;
+		}
+
+		void do_deallocate(void* p, const size_t bytes, const size_t align) override
+		{
+			const size_t size = std::max(bytes, align);
+			if (size > core_->opts.largest_required_pool_block)
+			{
+				std::lock_guard lock{core_->large_mutex};
+				core_->large.deallocate(core_->upstream, p, bytes, align);
+				return;
+			}
+
+			const size_t c = internal::PoolClass(size);
+			Magazine& m = magazine();
+			if (m.epoch != core_->epoch.load(std::memory_order_relaxed)) adopt(m);
+			if (m.count[c] == capacity)
+			{
+				std::lock_guard lock{core_->bins[c].mutex};
+				while (m.count[c] > capacity - refill) core_->bins[c].pool.deallocate(m.pop(c));
+			}
+			m.push(c, p);
+		}
+
+		[[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+	private:
+		static constexpr unsigned capacity = 64;
+		static constexpr unsigned refill = 16;
+
+		[[nodiscard]] static std::uint64_t next_epoch() noexcept
+		{
+			static std::atomic<std::uint64_t> counter{0};
+			return ++counter;
+		}
+
+		struct Bin
+		{
+			std::mutex mutex;
+			internal::PoolBin pool;
+		};
+
+		struct Core
+		{
+			Core(std::pmr::memory_resource* upstream, const std::pmr::pool_options& opts) noexcept
+				: upstream{upstream}, opts{opts}
+			{
+			}
+
+			~Core() { release(); }
+
+			void release() noexcept
+			{
+				epoch.store(next_epoch(), std::memory_order_relaxed);
+				for (size_t c = 0; c < internal::max_pool_classes; ++c)
+				{
+					std::lock_guard lock{bins[c].mutex};
+					bins[c].pool.release(upstream, internal::PoolBlock(c));
+				}
+				std::lock_guard lock{large_mutex};
+				large.release(upstream);
+			}
+
+			std::pmr::memory_resource* const upstream;
+			const std::pmr::pool_options opts;
+			std::atomic<std::uint64_t> epoch{next_epoch()};
+			Bin bins[internal::max_pool_classes];
+			std::mutex large_mutex;
+			internal::LargeBlocks large;
+		};
+
+		// Epochs are unique across all resources and change on release(), so a magazine whose epoch
+		// matches can only hold blocks that are still valid for this resource
+		struct Magazine
+		{
+			~Magazine() { flush(); }
+
+			[[nodiscard]] void* pop(const size_t c) noexcept
+			{
+				void* const p = head[c];
+				head[c] = *static_cast<void**>(p);
+				--count[c];
+				return p;
+			}
+
+			void push(const size_t c, void* p) noexcept
+			{
+				*static_cast<void**>(p) = head[c];
+				head[c] = p;
+				++count[c];
+			}
+
+			void flush() noexcept
+			{
+				if (const auto core = owner.lock(); core && core->epoch.load(std::memory_order_relaxed) == epoch)
+				{
+					for (size_t c = 0; c < internal::max_pool_classes; ++c)
+					{
+						if (!count[c]) continue;
+						std::lock_guard lock{core->bins[c].mutex};
+						while (count[c]) core->bins[c].pool.deallocate(pop(c));
+					}
+				}
+				std::fill_n(head, internal::max_pool_classes, nullptr);
+				std::fill_n(count, internal::max_pool_classes, 0u);
+				owner.reset();
+				epoch = 0;
+			}
+
+			std::weak_ptr<Core> owner;
+			std::uint64_t epoch = 0;
+			void* head[internal::max_pool_classes]{};
+			unsigned count[internal::max_pool_classes]{};
+		};
+
+		[[nodiscard]] static Magazine& magazine() noexcept
+		{
+			thread_local Magazine m;
+			return m;
+		}
+
+		void adopt(Magazine& m) const noexcept
+		{
+			const auto epoch = core_->epoch.load(std::memory_order_relaxed);
+			if (m.epoch == epoch) return;
+			m.flush();
+			m.owner = core_;
+			m.epoch = epoch;
+		}
+
+		std::shared_ptr<Core> core_;
+	};
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "internal/alloc_traits.h"
+#include "internal/config.h"
+
+#ifdef OSTL_HAS_MMAP
+#include <sys/mman.h>
+#endif
+
+namespace ostl
+{
+	// Serves blocks of at least Threshold bytes straight from mmap, aligned and rounded up to 2 MiB and
+	// advised MADV_HUGEPAGE so that very large containers are backed by transparent huge pages. Populate
+	// pre-faults new mappings. Smaller blocks come from operator new, as do all blocks where mmap is
+	// unavailable. vector grows mapped blocks of trivially relocatable elements through reallocate(),
+	// which remaps pages with mremap on Linux instead of copying them.
+	template <class T, bool Populate = false, size_t Threshold = size_t{1} << 21>
+	class mmap_allocator
+	{
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using propagate_on_container_move_assignment = std::true_type;
+		using is_always_equal = std::true_type;
+
+		template <class U>
+		struct rebind
+		{
+			using other = mmap_allocator<U, Populate, Threshold>;
+		};
+
+		static constexpr size_t huge_page = size_t{1} << 21;
+
+		mmap_allocator() noexcept = default;
+
+		template <class U>
+		mmap_allocator(const mmap_allocator<U, Populate, Threshold>&) noexcept
+		{
+		}
+
+		[[nodiscard]] T* allocate(const size_t n) { return allocate_at_least(n).ptr; }
+
+		// Mapped blocks report the whole rounded-up mapping as capacity
+		[[nodiscard]] internal::AllocationResult<T*> allocate_at_least(const size_t n)
+		{
+			if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length{};
+			const size_t bytes = n * sizeof(T);
+			if (!is_mapped(bytes)) return {static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)})), n};
+
+			const size_t len = map_length(bytes);
+			return {static_cast<T*>(map(len)), len / sizeof(T)};
+		}
+
+		void deallocate(T* p, const size_t n) noexcept
+		{
+			const size_t bytes = n * sizeof(T);
+#ifdef OSTL_HAS_MMAP
+			if (is_mapped(bytes))
+			{
+				::munmap(p, map_length(bytes));
+				return;
+			}
+#endif
+			::operator delete(p, std::align_val_t{alignof(T)});
+		}
+
+		// Resizes a block of old_n elements to hold at least n, moving the contents bytewise
+		[[nodiscard]] internal::AllocationResult<T*> reallocate(T* p, const size_t old_n, const size_t n)
+		{
+			if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length{};
+			const size_t old_bytes = old_n * sizeof(T), bytes = n * sizeof(T);
+
+#if defined(OSTL_HAS_MMAP) && defined(MREMAP_FIXED)
+			if (p && is_mapped(old_bytes) && is_mapped(bytes))
+			{
+				const size_t old_len = map_length(old_bytes), len = map_length(bytes);
+				void* q = ::mremap(p, old_len, len, 0);
+				if (q == MAP_FAILED)
+				{
+					// A moving mremap only keeps page alignment, so reserve an aligned range and move the pages
+					// onto it. Everything that can fail happens while p is still valid.
+					void* const dst = map_aligned(len, PROT_NONE);
+					q = ::mremap(p, old_len, len, MREMAP_MAYMOVE | MREMAP_FIXED, dst);
+					if (q == MAP_FAILED)
+					{
+						::munmap(dst, len);
+						throw std::bad_alloc{};
+					}
+				}
+				prepare(q, len);
+				return {static_cast<T*>(q), len / sizeof(T)};
+			}
+#endif
+
+			const auto r = allocate_at_least(n);
+			if (p)
+			{
+				std::memcpy(static_cast<void*>(r.ptr), static_cast<const void*>(p), std::min(old_bytes, bytes));
+				deallocate(p, old_n);
+			}
+			return r;
+		}
+
+		[[nodiscard]] friend bool operator==(const mmap_allocator&, const mmap_allocator&) noexcept { return true; }
+		[[nodiscard]] friend bool operator!=(const mmap_allocator&, const mmap_allocator&) noexcept { return false; }
+
+	private:
+		[[nodiscard]] static constexpr bool is_mapped(const size_t bytes) noexcept
+		{
+#ifdef OSTL_HAS_MMAP
+			return bytes >= Threshold;
+#else
+			return false;
+#endif
+		}
+
+		[[nodiscard]] static constexpr size_t map_length(const size_t bytes) noexcept
+		{
+			return (bytes + (huge_page - 1)) & ~(huge_page - 1);
+		}
+
+#ifdef OSTL_HAS_MMAP
+		[[nodiscard]] static void* map(const size_t len)
+		{
+			void* const p = map_aligned(len, PROT_READ | PROT_WRITE);
+			prepare(p, len);
+			return p;
+		}
+
+		// Over-maps by one huge page and trims both ends so the block starts on a huge page boundary
+		[[nodiscard]] static void* map_aligned(const size_t len, const int prot)
+		{
+			void* const raw = ::mmap(nullptr, len + huge_page, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (raw == MAP_FAILED) throw std::bad_alloc{};
+
+			const auto addr = reinterpret_cast<uintptr_t>(raw);
+			const uintptr_t aligned = (addr + (huge_page - 1)) & ~uintptr_t(huge_page - 1);
+			if (aligned != addr) ::munmap(raw, aligned - addr);
+			if (const size_t tail = addr + len + huge_page - (aligned + len)) ::munmap(reinterpret_cast<void*>(aligned + len), tail);
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		// Advises huge pages before populating, so that the pre-faulted pages are huge ones too. This is
+		// why Populate does not use MAP_POPULATE, which faults the range in before the advice applies.
+		static void prepare(void* p, const size_t len) noexcept
+		{
+#ifdef MADV_HUGEPAGE
+			::madvise(p, len, MADV_HUGEPAGE);
+#endif
+			if constexpr (Populate)
+			{
+#ifdef MADV_POPULATE_WRITE
+				if (::madvise(p, len, MADV_POPULATE_WRITE) == 0) return;
+#endif
+				const auto bytes = static_cast<volatile char*>(p);
+				for (size_t i = 0; i < len; i += 4096) bytes[i] = 0;
+			}
+		}
+#else
+		[[nodiscard]] static void* map(size_t) { return nullptr; }
+		static void prepare(void*, size_t) noexcept {}
+#endif
+	};
+}
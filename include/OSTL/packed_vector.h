@@ -0,0 +1,741 @@
+#pragma once
+
+#include <cstdint>
+#include "vector.h"
+
+namespace ostl
+{
+	namespace internal
+	{
+		template <unsigned Bits>
+		using PackedValue = std::conditional_t<Bits <= 8, std::uint8_t, std::conditional_t<Bits <= 16, std::uint16_t,
+			std::conditional_t<Bits <= 32, std::uint32_t, std::uint64_t>>>;
+
+		[[nodiscard]] constexpr Word ShiftRight(const Word x, const size_t n) noexcept
+		{
+			return n < word_bits ? x >> n : 0;
+		}
+
+		// Overwrites n <= word_bits bits starting at bit pos, which may straddle two words
+		inline void StoreBits(Word* words, const size_t pos, const size_t n, const Word v) noexcept
+		{
+			const size_t first = std::min(n, word_bits - pos % word_bits);
+			DepositBits(words, pos, first, v);
+			if (first < n) DepositBits(words, pos + first, n - first, v >> first);
+		}
+
+		// Streams words instead of locating every element, so each word is loaded once
+		template <unsigned Bits, class T>
+		void UnpackScalar(const Word* words, const size_t first, const size_t n, T* out) noexcept
+		{
+			if (n == 0) return;
+
+			constexpr Word mask = LowMask(Bits);
+			size_t w = first * Bits / word_bits;
+			size_t avail = word_bits - first * Bits % word_bits;
+			Word cur = words[w] >> (word_bits - avail);
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (avail >= Bits)
+				{
+					out[i] = static_cast<T>(cur & mask);
+					cur = ShiftRight(cur, Bits);
+					avail -= Bits;
+				}
+				else
+				{
+					const Word next = words[++w];
+					out[i] = static_cast<T>((cur | next << avail) & mask);
+					cur = ShiftRight(next, Bits - avail);
+					avail += word_bits - Bits;
+				}
+			}
+		}
+
+		template <unsigned Bits, class T>
+		void PackScalar(Word* words, const size_t first, const size_t n, const T* in) noexcept
+		{
+			if (n == 0) return;
+
+			constexpr Word mask = LowMask(Bits);
+			size_t w = first * Bits / word_bits;
+			size_t fill = first * Bits % word_bits;
+			Word acc = words[w] & LowMask(fill);
+			for (size_t i = 0; i < n; ++i)
+			{
+				const Word v = static_cast<Word>(in[i]) & mask;
+				acc |= v << fill;
+				fill += Bits;
+				if (fill >= word_bits)
+				{
+					words[w++] = acc;
+					fill -= word_bits;
+					acc = fill ? v >> (Bits - fill) : 0;
+				}
+			}
+			if (fill) words[w] = (words[w] & ~LowMask(fill)) | acc;
+		}
+
+#ifdef OSTL_X64
+		// Eight elements per step: gather the 32 bits at each element's first byte, shift by its bit phase
+		// and mask. Eight elements span exactly Bits bytes, so the per-lane offsets never change. Returns
+		// how many elements were unpacked; the caller finishes the rest.
+		template <unsigned Bits, class T>
+		OSTL_TARGET("avx2") size_t UnpackAvx2(const Word* words, const size_t first, const size_t n,
+		                                      const size_t word_count, T* out) noexcept
+		{
+			static_assert(Bits + 7 <= 32 && sizeof(T) <= 4);
+
+			const size_t phase = first * Bits % 8;
+			const size_t end = word_count * sizeof(Word) - 4 - (phase + 7 * Bits) / 8;
+			size_t offset = first * Bits / 8;
+			const auto bytes = reinterpret_cast<const int*>(words);
+
+			alignas(32) int index[8], shift[8];
+			for (auto k = 0; k < 8; ++k)
+			{
+				index[k] = static_cast<int>((phase + k * Bits) / 8);
+				shift[k] = static_cast<int>((phase + k * Bits) % 8);
+			}
+			const __m256i vindex = _mm256_load_si256(reinterpret_cast<const __m256i*>(index));
+			const __m256i vshift = _mm256_load_si256(reinterpret_cast<const __m256i*>(shift));
+			const __m256i vmask = _mm256_set1_epi32(static_cast<int>(LowMask(Bits)));
+
+			size_t i = 0;
+			for (; i + 8 <= n && offset <= end; i += 8, offset += Bits)
+			{
+				const auto base = reinterpret_cast<const int*>(reinterpret_cast<const char*>(bytes) + offset);
+				__m256i v = _mm256_i32gather_epi32(base, vindex, 1);
+				v = _mm256_and_si256(_mm256_srlv_epi32(v, vshift), vmask);
+
+				if constexpr (sizeof(T) == 4)
+				{
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+				}
+				else if constexpr (sizeof(T) == 2)
+				{
+					v = _mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), 0b1000);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(v));
+				}
+				else
+				{
+					v = _mm256_packus_epi16(_mm256_packus_epi32(v, v), v);
+					v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(v));
+				}
+			}
+			return i;
+		}
+
+		// The inverse of UnpackAvx2. Eight masked elements are merged in 64-bit lanes, then within each 128-bit
+		// half, giving two runs of 4 * Bits bits; the upper run is shifted into place behind the lower one and
+		// both are stored unaligned. Stores spill past the group's Bits bytes, but the next group overwrites
+		// the spill, and the loop stops while a whole store still fits before the last element, so nothing
+		// outside [first, first + n) is touched. first * Bits must be a multiple of 8. Returns how many
+		// elements were packed; the caller finishes the rest.
+		template <unsigned Bits, class T>
+		OSTL_TARGET("avx2") size_t PackAvx2(Word* words, const size_t first, const size_t n, const T* in) noexcept
+		{
+			static_assert(Bits + 7 <= 32 && sizeof(T) <= 4 && std::is_unsigned_v<T>);
+
+			constexpr int q = 4 * Bits / 8, r = 4 * Bits % 8;
+			const size_t end = (first + n) * Bits / 8;
+			size_t offset = first * Bits / 8;
+			const auto bytes = reinterpret_cast<char*>(words);
+
+			const __m256i vmask = _mm256_set1_epi32(static_cast<int>(LowMask(Bits)));
+			const __m256i lo32 = _mm256_set1_epi64x(0xFFFFFFFF);
+			const __m256i lo64 = _mm256_setr_epi64x(-1, 0, -1, 0), hi64 = _mm256_setr_epi64x(0, -1, 0, -1);
+
+			size_t i = 0;
+			for (; i + 8 <= n && offset + q + 16 <= end; i += 8, offset += Bits)
+			{
+				__m256i v;
+				if constexpr (sizeof(T) == 4)
+					v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+				else if constexpr (sizeof(T) == 2)
+					v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+				else
+					v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+				v = _mm256_and_si256(v, vmask);
+
+				v = _mm256_or_si256(_mm256_and_si256(v, lo32), _mm256_slli_epi64(_mm256_srli_epi64(v, 32), Bits));
+				v = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(v, lo64),
+				                                    _mm256_bsrli_epi128(_mm256_slli_epi64(v, 2 * Bits), 8)),
+				                    _mm256_and_si256(_mm256_srli_epi64(v, 64 - 2 * Bits), hi64));
+
+				const __m128i lo = _mm256_castsi256_si128(v), hi = _mm256_extracti128_si256(v, 1);
+				const __m128i top = _mm_or_si128(_mm_or_si128(_mm_slli_epi64(hi, r),
+				                                              _mm_srli_epi64(_mm_bslli_si128(hi, 8), 64 - r)),
+				                                 _mm_bsrli_si128(lo, q));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + offset), lo);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + offset + q), top);
+			}
+			return i;
+		}
+#endif
+
+		// Reads elements [first, first + n) of a packed array of word_count words
+		template <unsigned Bits, class T>
+		void Unpack(const Word* words, const size_t first, const size_t n, const size_t word_count, T* out) noexcept
+		{
+			size_t i = 0;
+#ifdef OSTL_X64
+			if constexpr (Bits + 7 <= 32 && sizeof(T) <= 4)
+			{
+				if (HasAvx2() && word_count * sizeof(Word) >= 4 + (7 + 7 * Bits) / 8)
+					i = UnpackAvx2<Bits>(words, first, n, word_count, out);
+			}
+#endif
+			UnpackScalar<Bits>(words, first + i, n - i, out + i);
+		}
+
+		// Overwrites elements [first, first + n) of a packed array
+		template <unsigned Bits, class T>
+		void Pack(Word* words, const size_t first, const size_t n, const T* in) noexcept
+		{
+			size_t i = 0;
+#ifdef OSTL_X64
+			if constexpr (Bits + 7 <= 32 && sizeof(T) <= 4 && std::is_unsigned_v<T>)
+			{
+				if (HasAvx2())
+				{
+					// The kernel starts on a byte boundary, which every eighth element is
+					i = std::min(n, (8 - first % 8) % 8);
+					PackScalar<Bits>(words, first, i, in);
+					i += PackAvx2<Bits>(words, first + i, n - i, in + i);
+				}
+			}
+#endif
+			PackScalar<Bits>(words, first + i, n - i, in + i);
+		}
+	}
+
+	// A vector of Bits-wide unsigned integers packed back to back into words, like vector<bool> for wider
+	// values. Elements may straddle two words. unpack/pack/append move whole runs between the packed
+	// form and plain arrays much faster than element access, eight elements per step with AVX2 when
+	// Bits <= 25.
+	template <unsigned Bits, class Alloc = std::allocator<internal::PackedValue<Bits>>>
+	class packed_vector
+	{
+		static_assert(Bits > 0 && Bits <= internal::word_bits, "Bits must fit in a word");
+
+	public:
+		using value_type = internal::PackedValue<Bits>;
+		using allocator_type = Alloc;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using const_reference = value_type;
+
+		static constexpr unsigned bits = Bits;
+		static constexpr value_type max_value = static_cast<value_type>(internal::LowMask(Bits));
+
+	private:
+		using int_type = internal::Word;
+		static constexpr size_type n_bit = internal::word_bits;
+
+		[[nodiscard]] static constexpr size_type words_for(const size_type n) noexcept
+		{
+			return (n * Bits + (n_bit - 1)) / n_bit;
+		}
+
+	public:
+		class iterator;
+
+		class reference
+		{
+		public:
+			[[nodiscard]] operator value_type() const noexcept
+			{
+				return static_cast<value_type>(internal::ExtractBits(words_, idx_ * Bits, Bits));
+			}
+
+			~reference() = default;
+			reference(const reference&) = delete;
+			reference(reference&&) = delete;
+
+			reference& operator=(reference&& x) noexcept { return *this = static_cast<value_type>(x); }
+			reference& operator=(const reference& x) noexcept { return *this = static_cast<value_type>(x); }
+
+			reference& operator=(const value_type x) noexcept
+			{
+				internal::StoreBits(words_, idx_ * Bits, Bits, x);
+				return *this;
+			}
+
+		private:
+			friend packed_vector;
+			friend iterator;
+
+			reference(int_type* words, const size_type idx) noexcept : words_{words}, idx_{idx}
+			{
+			}
+
+			int_type* words_;
+			const size_type idx_;
+		};
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename packed_vector::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = value_type*;
+			using reference = value_type;
+
+			const_iterator() = default;
+
+			const_iterator(int_type* words, const size_type idx) : words_{words}, idx_{idx}
+			{
+			}
+
+			[[nodiscard]] value_type operator*() const
+			{
+				return static_cast<value_type>(internal::ExtractBits(words_, idx_ * Bits, Bits));
+			}
+
+			[[nodiscard]] value_type operator[](const difference_type n) const { return *(*this + n); }
+
+			const_iterator& operator++() { return *this += 1; }
+
+			const_iterator operator++(int)
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			const_iterator& operator--() { return *this -= 1; }
+
+			const_iterator operator--(int)
+			{
+				const auto it = *this;
+				--*this;
+				return it;
+			}
+
+			const_iterator& operator+=(const difference_type n)
+			{
+				idx_ += n;
+				return *this;
+			}
+
+			[[nodiscard]] const_iterator operator+(const difference_type n) const
+			{
+				const_iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			const_iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] const_iterator operator-(const difference_type n) const { return *this + -n; }
+
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const
+			{
+				return static_cast<difference_type>(idx_ - rhs.idx_);
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const { return idx_ == rhs.idx_; }
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+			[[nodiscard]] bool operator<(const const_iterator& rhs) const { return idx_ < rhs.idx_; }
+			[[nodiscard]] bool operator>(const const_iterator& rhs) const { return rhs < *this; }
+			[[nodiscard]] bool operator>=(const const_iterator& rhs) const { return !(*this < rhs); }
+			[[nodiscard]] bool operator<=(const const_iterator& rhs) const { return !(*this > rhs); }
+
+		protected:
+			friend packed_vector;
+
+			int_type* words_ = nullptr;
+			size_type idx_ = 0;
+		};
+
+		class iterator : public const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename packed_vector::value_type;
+			using difference_type = ptrdiff_t;
+			using reference = typename packed_vector::reference;
+			using pointer = reference*;
+
+			iterator() = default;
+
+			iterator(int_type* words, const size_type idx) : const_iterator{words, idx}
+			{
+			}
+
+			[[nodiscard]] reference operator*() const { return {this->words_, this->idx_}; }
+			[[nodiscard]] reference operator[](const difference_type n) const { return {this->words_, this->idx_ + n}; }
+
+			iterator& operator++() { return *this += 1; }
+
+			iterator operator++(int)
+			{
+				iterator it = *this;
+				++*this;
+				return it;
+			}
+
+			iterator& operator--() { return *this -= 1; }
+
+			iterator operator--(int)
+			{
+				iterator it = *this;
+				--*this;
+				return it;
+			}
+
+			iterator& operator+=(const difference_type n)
+			{
+				const_iterator::operator+=(n);
+				return *this;
+			}
+
+			[[nodiscard]] iterator operator+(const difference_type n) const
+			{
+				iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] iterator operator-(const difference_type n) const { return *this + -n; }
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const { return const_iterator::operator-(rhs); }
+		};
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		packed_vector() = default;
+
+		explicit packed_vector(const Alloc& alloc) noexcept : vec_{word_alloc{alloc}}
+		{
+		}
+
+		packed_vector(const size_type n, const value_type value, const Alloc& alloc = Alloc{}) : packed_vector{alloc}
+		{
+			assign(n, value);
+		}
+
+		explicit packed_vector(const size_type n, const Alloc& alloc = Alloc{})
+			: vec_(words_for(n), 0, word_alloc{alloc}), size_{n}
+		{
+		}
+
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
+			                            iterator_category>
+			          || std::is_same_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
+			                            iterator_category>>>
+		packed_vector(InputIt first, InputIt last, const Alloc& alloc = Alloc{}) : packed_vector{alloc}
+		{
+			insert(cend(), first, last);
+		}
+
+		packed_vector(const std::initializer_list<value_type> init, const Alloc& alloc = Alloc{})
+			: packed_vector{alloc}
+		{
+			append(init.begin(), init.size());
+		}
+
+		packed_vector(const packed_vector&) = default;
+		packed_vector(const packed_vector& x, const Alloc& alloc) : vec_{x.vec_, word_alloc{alloc}}, size_{x.size_}
+		{
+		}
+
+		packed_vector(packed_vector&& x) noexcept : vec_{std::move(x.vec_)}, size_{x.size_} { x.size_ = 0; }
+
+		packed_vector(packed_vector&& x, const Alloc& alloc) : vec_{std::move(x.vec_), word_alloc{alloc}}, size_{x.size_}
+		{
+			x.size_ = 0;
+		}
+
+		~packed_vector() = default;
+
+		packed_vector& operator=(const packed_vector&) = default;
+
+		packed_vector& operator=(packed_vector&& x) noexcept(noexcept(std::declval<word_vector&>() = std::declval<word_vector>()))
+		{
+			vec_ = std::move(x.vec_);
+			size_ = x.size_;
+			x.size_ = 0;
+			return *this;
+		}
+
+		packed_vector& operator=(const std::initializer_list<value_type> init)
+		{
+			assign(init);
+			return *this;
+		}
+
+		void assign(const size_type n, const value_type value)
+		{
+			clear();
+			insert(cend(), n, value);
+		}
+
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
+			                            iterator_category>
+			          || std::is_same_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
+			                            iterator_category>>>
+		void assign(InputIt first, InputIt last)
+		{
+			clear();
+			insert(cend(), first, last);
+		}
+
+		void assign(const std::initializer_list<value_type> init)
+		{
+			clear();
+			append(init.begin(), init.size());
+		}
+
+		[[nodiscard]] allocator_type get_allocator() const noexcept { return allocator_type(vec_.get_allocator()); }
+
+		[[nodiscard]] reference at(const size_type n)
+		{
+			if (n >= size_) throw std::out_of_range{""};
+			return (*this)[n];
+		}
+
+		[[nodiscard]] const_reference at(const size_type n) const
+		{
+			if (n >= size_) throw std::out_of_range{""};
+			return (*this)[n];
+		}
+
+		[[nodiscard]] reference operator[](const size_type n) { return {vec_.data(), n}; }
+		[[nodiscard]] const_reference operator[](const size_type n) const { return begin()[n]; }
+		[[nodiscard]] reference front() { return (*this)[0]; }
+		[[nodiscard]] const_reference front() const { return (*this)[0]; }
+		[[nodiscard]] reference back() { return (*this)[size_ - 1]; }
+		[[nodiscard]] const_reference back() const { return (*this)[size_ - 1]; }
+
+		[[nodiscard]] iterator begin() noexcept { return {vec_.data(), 0}; }
+		[[nodiscard]] const_iterator begin() const noexcept { return cbegin(); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return {const_cast<int_type*>(vec_.data()), 0}; }
+
+		[[nodiscard]] iterator end() noexcept { return {vec_.data(), size_}; }
+		[[nodiscard]] const_iterator end() const noexcept { return cend(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return {const_cast<int_type*>(vec_.data()), size_}; }
+
+		[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{cend()}; }
+
+		[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return const_reverse_iterator{cbegin()}; }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+
+		[[nodiscard]] constexpr size_type max_size() const noexcept
+		{
+			return std::numeric_limits<difference_type>::max() / Bits;
+		}
+
+		void reserve(const size_type n) { vec_.reserve(words_for(n)); }
+		[[nodiscard]] size_type capacity() const noexcept { return vec_.capacity() * n_bit / Bits; }
+		void shrink_to_fit() { vec_.shrink_to_fit(); }
+
+		// Backing words, element i at bit i * Bits. Bits of the last word past size() * Bits are unspecified.
+		[[nodiscard]] const int_type* words() const noexcept { return vec_.data(); }
+
+		void clear() noexcept
+		{
+			vec_.clear();
+			size_ = 0;
+		}
+
+		iterator insert(const const_iterator position, const value_type x) { return insert(position, 1, x); }
+
+		iterator insert(const const_iterator position, const size_type n, const value_type x)
+		{
+			const size_type d = position - cbegin();
+			if (n == 0) return begin() + d;
+
+			move(d, d + n, size_ - d);
+			size_ += n;
+
+			// Streams from a short run of copies rather than storing one element at a time
+			constexpr size_type run_size = 64;
+			value_type run[run_size];
+			std::fill_n(run, run_size, x);
+			for (size_type i = 0; i < n; i += run_size)
+				internal::Pack<Bits>(vec_.data(), d + i, std::min(run_size, n - i), run);
+			return begin() + d;
+		}
+
+		template <class InputIt, class = std::enable_if_t<
+			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
+			                            iterator_category>
+			          || std::is_same_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
+			                            iterator_category>>>
+		iterator insert(const const_iterator position, InputIt first, InputIt last)
+		{
+			const size_type d = position - cbegin();
+			if constexpr (internal::IsForwardIterator<InputIt>)
+			{
+				if constexpr (std::is_same_v<InputIt, iterator> || std::is_same_v<InputIt, const_iterator>)
+				{
+					// Growing could free the source words, so a range of our own elements goes through a copy
+					if (first.words_ == vec_.data() && first != last)
+					{
+						const packed_vector copy(first, last, get_allocator());
+						return insert(position, copy.cbegin(), copy.cend());
+					}
+				}
+
+				const size_type n = std::distance(first, last);
+				move(d, d + n, size_ - d);
+				size_ += n;
+
+				if constexpr (std::is_same_v<InputIt, iterator> || std::is_same_v<InputIt, const_iterator>)
+				{
+					internal::CopyBits(vec_.data(), d * Bits, first.words_, first.idx_ * Bits, n * Bits);
+				}
+				else if constexpr (std::is_pointer_v<InputIt>
+					&& std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, value_type>)
+				{
+					internal::Pack<Bits>(vec_.data(), d, n, first);
+				}
+				else
+				{
+					for (auto it = begin() + d; first != last; ++it, ++first) *it = static_cast<value_type>(*first);
+				}
+			}
+			else
+			{
+				packed_vector copy{get_allocator()};
+				for (; first != last; ++first) copy.push_back(static_cast<value_type>(*first));
+				return insert(position, copy.cbegin(), copy.cend());
+			}
+			return begin() + d;
+		}
+
+		iterator insert(const const_iterator position, const std::initializer_list<value_type> list)
+		{
+			return insert(position, list.begin(), list.end());
+		}
+
+		iterator erase(const const_iterator position) { return erase(position, position + 1); }
+
+		iterator erase(const const_iterator first, const const_iterator last)
+		{
+			const size_type f = first - cbegin(), l = last - cbegin();
+			move(l, f, size_ - l);
+			size_ -= l - f;
+			return begin() + f;
+		}
+
+		void push_back(const value_type x)
+		{
+			inc_cap(size_ + 1);
+			internal::StoreBits(vec_.data(), size_++ * Bits, Bits, x);
+		}
+
+		void pop_back() { --size_; }
+
+		void resize(const size_type sz) { resize(sz, 0); }
+
+		void resize(const size_type sz, const value_type c)
+		{
+			if (size_ < sz)
+				insert(cend(), sz - size_, c);
+			else
+				size_ = sz;
+		}
+
+		void swap(packed_vector& other) noexcept(noexcept(std::declval<word_vector&>().swap(std::declval<word_vector&>())))
+		{
+			vec_.swap(other.vec_);
+			std::swap(size_, other.size_);
+		}
+
+		// Copies elements [pos, pos + n) to out
+		void unpack(const size_type pos, const size_type n, value_type* out) const noexcept
+		{
+			internal::Unpack<Bits>(vec_.data(), pos, n, vec_.size(), out);
+		}
+
+		// Overwrites elements [pos, pos + n) with in[0, n), keeping only the low Bits of each
+		void pack(const size_type pos, const size_type n, const value_type* in) noexcept
+		{
+			internal::Pack<Bits>(vec_.data(), pos, n, in);
+		}
+
+		void append(const value_type* in, const size_type n)
+		{
+			inc_cap(size_ + n);
+			internal::Pack<Bits>(vec_.data(), size_, n, in);
+			size_ += n;
+		}
+
+	private:
+		using word_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<int_type>;
+		using word_vector = vector<int_type, word_alloc>;
+
+		void move(const size_type src, const size_type dest, const size_type cnt)
+		{
+			if (dest > src) inc_cap(size_ + (dest - src));
+			internal::CopyBits(vec_.data(), dest * Bits, vec_.data(), src * Bits, cnt * Bits);
+		}
+
+		void inc_cap(const size_type min)
+		{
+			if (words_for(min) > vec_.size())
+				vec_.resize_for_overwrite(words_for(min));
+		}
+
+		word_vector vec_;
+		size_type size_ = 0;
+	};
+
+	template <unsigned Bits, class Alloc>
+	[[nodiscard]] bool operator==(const packed_vector<Bits, Alloc>& lhs, const packed_vector<Bits, Alloc>& rhs)
+	{
+		if (lhs.size() != rhs.size()) return false;
+		const size_t bits = lhs.size() * Bits, whole = bits / internal::word_bits, rest = bits % internal::word_bits;
+		if (!std::equal(lhs.words(), lhs.words() + whole, rhs.words())) return false;
+		return !rest || ((lhs.words()[whole] ^ rhs.words()[whole]) & internal::LowMask(rest)) == 0;
+	}
+
+	template <unsigned Bits, class Alloc>
+	[[nodiscard]] bool operator!=(const packed_vector<Bits, Alloc>& lhs, const packed_vector<Bits, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <unsigned Bits, class Alloc>
+	[[nodiscard]] bool operator<(const packed_vector<Bits, Alloc>& lhs, const packed_vector<Bits, Alloc>& rhs)
+	{
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <unsigned Bits, class Alloc>
+	[[nodiscard]] bool operator<=(const packed_vector<Bits, Alloc>& lhs, const packed_vector<Bits, Alloc>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template <unsigned Bits, class Alloc>
+	[[nodiscard]] bool operator>(const packed_vector<Bits, Alloc>& lhs, const packed_vector<Bits, Alloc>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template <unsigned Bits, class Alloc>
+	[[nodiscard]] bool operator>=(const packed_vector<Bits, Alloc>& lhs, const packed_vector<Bits, Alloc>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template <unsigned Bits, class Alloc>
+	void swap(packed_vector<Bits, Alloc>& lhs, packed_vector<Bits, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+	{
+		lhs.swap(rhs);
+	}
+}
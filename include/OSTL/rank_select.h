@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "vector.h"
+
+namespace ostl
+{
+	// Constant time rank and fast select over a vector<bool>, in the layout of Zhou et al.'s rank9/poppy:
+	// one 64-bit entry per 2048-bit superblock holds the rank at its start (relative to the enclosing
+	// 2^32-bit region) and the popcounts of its first three 512-bit blocks, so a rank reads one entry and
+	// at most eight words. select1 binary searches the superblocks between two samples taken every 8192
+	// set bits. The index costs a little over 3% of the bitmap.
+	//
+	// The index points into the bitmap's words: it must be updated after the bitmap is modified or
+	// reallocated. update() after appends only rescans from the last superblock.
+	template <class Alloc = std::allocator<std::uint64_t>>
+	class rank_select
+	{
+	public:
+		using size_type = size_t;
+		using allocator_type = Alloc;
+
+		static constexpr auto npos = size_type(-1);
+
+		rank_select() = default;
+
+		explicit rank_select(const Alloc& alloc) noexcept : upper_{alloc}, blocks_{alloc}, samples_{alloc}
+		{
+		}
+
+		template <class A, class G, size_t N>
+		explicit rank_select(const vector<bool, A, G, N>& bits, const Alloc& alloc = Alloc{}) : rank_select{alloc}
+		{
+			update(bits);
+		}
+
+		// Re-indexes bits, which must extend the bitmap indexed so far
+		template <class A, class G, size_t N>
+		void update(const vector<bool, A, G, N>& bits)
+		{
+			words_ = bits.words();
+			const size_type first = std::min(size_ / superblock_bits, blocks_.size());
+			size_type ones = first < blocks_.size() ? absolute(first) : ones_;
+			blocks_.resize(first);
+			upper_.resize((first + (per_upper - 1)) / per_upper);
+			while (!samples_.empty() && (samples_.size() - 1) * sample_rate >= ones) samples_.pop_back();
+
+			size_ = bits.size();
+			const size_type words = (size_ + (word_bits - 1)) / word_bits;
+			for (size_type s = first; s * superblock_bits < size_; ++s)
+			{
+				if (s % per_upper == 0) upper_.push_back(ones);
+
+				std::uint64_t entry = ones - upper_.back();
+				size_type total = 0;
+				for (size_type b = 0; b < 4; ++b)
+				{
+					size_type c = 0;
+					const size_type w0 = s * superblock_words + b * block_words;
+					for (size_type w = w0; w < std::min(w0 + block_words, words); ++w) c += std::popcount(word(w));
+					if (b < 3) entry |= std::uint64_t{c} << (32 + 10 * b);
+					total += c;
+				}
+				blocks_.push_back(entry);
+
+				while (samples_.size() * sample_rate < ones + total) samples_.push_back(s);
+				ones += total;
+			}
+			ones_ = ones;
+		}
+
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+		[[nodiscard]] size_type count() const noexcept { return ones_; }
+
+		// Number of set bits in [0, i), i <= size()
+		[[nodiscard]] size_type rank1(const size_type i) const noexcept
+		{
+			const size_type s = i / superblock_bits;
+			if (s == blocks_.size()) return ones_;
+
+			size_type r = absolute(s);
+			const size_type b = i % superblock_bits / block_bits;
+			for (size_type j = 0; j < b; ++j) r += sub_count(s, j);
+
+			const size_type last = i / word_bits;
+			for (size_type w = s * superblock_words + b * block_words; w < last; ++w) r += std::popcount(words_[w]);
+			if (i % word_bits) r += std::popcount(words_[last] & internal::LowMask(i % word_bits));
+			return r;
+		}
+
+		[[nodiscard]] size_type rank0(const size_type i) const noexcept { return i - rank1(i); }
+
+		// Position of the k-th (0-based) set bit, or npos if there are no more than k
+		[[nodiscard]] size_type select1(const size_type k) const noexcept
+		{
+			if (k >= ones_) return npos;
+
+			const size_type j = k / sample_rate;
+			const size_type lo = samples_[j];
+			const size_type hi = j + 1 < samples_.size() ? samples_[j + 1] + 1 : blocks_.size();
+			size_type s = lo, n = hi - lo;
+			while (n > 1)
+			{
+				const size_type half = n / 2;
+				if (absolute(s + half) <= k)
+				{
+					s += half;
+					n -= half;
+				}
+				else n = half;
+			}
+
+			size_type r = k - absolute(s);
+			size_type b = 0;
+			for (; b < 3; ++b)
+			{
+				const size_type c = sub_count(s, b);
+				if (r < c) break;
+				r -= c;
+			}
+
+			size_type w = s * superblock_words + b * block_words;
+			for (size_type c; (c = std::popcount(words_[w])) <= r; ++w) r -= c;
+			return w * word_bits + internal::SelectInWord(words_[w], r);
+		}
+
+		[[nodiscard]] allocator_type get_allocator() const noexcept { return blocks_.get_allocator(); }
+
+	private:
+		using word_type = internal::Word;
+		static constexpr size_type word_bits = internal::word_bits;
+		static constexpr size_type block_bits = 512;
+		static constexpr size_type superblock_bits = 4 * block_bits;
+		static constexpr size_type block_words = block_bits / word_bits;
+		static constexpr size_type superblock_words = superblock_bits / word_bits;
+		static constexpr size_type per_upper = (std::uint64_t{1} << 32) / superblock_bits;
+		static constexpr size_type sample_rate = 8192;
+
+		[[nodiscard]] size_type absolute(const size_type s) const noexcept
+		{
+			return upper_[s / per_upper] + (blocks_[s] & 0xffffffff);
+		}
+
+		[[nodiscard]] size_type sub_count(const size_type s, const size_type b) const noexcept
+		{
+			return blocks_[s] >> (32 + 10 * b) & 0x3ff;
+		}
+
+		// Bits past size() in the last word are unspecified
+		[[nodiscard]] word_type word(const size_type w) const noexcept
+		{
+			const size_type rest = size_ - w * word_bits;
+			return rest < word_bits ? words_[w] & internal::LowMask(rest) : words_[w];
+		}
+
+		using index_vector = vector<std::uint64_t, typename std::allocator_traits<Alloc>::template rebind_alloc<std::uint64_t>>;
+
+		index_vector upper_;
+		index_vector blocks_;
+		index_vector samples_;
+		const word_type* words_ = nullptr;
+		size_type size_ = 0;
+		size_type ones_ = 0;
+	};
+}
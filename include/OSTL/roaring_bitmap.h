@@ -0,0 +1,638 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include "vector.h"
+
+namespace ostl
+{
+	// Compressed set of 32-bit integers (Chambi, Lemire et al.'s Roaring). The high 16 bits select a
+	// chunk, which stores its low 16 bits as a sorted array while it holds at most 4096 values and as a
+	// 2^16-bit vector<bool> above that. run_optimize() turns chunks that are cheaper as runs into run
+	// containers; mutating a run chunk converts it back first.
+	class roaring_bitmap
+	{
+	public:
+		using value_type = std::uint32_t;
+		using size_type = size_t;
+
+		class const_iterator;
+		using iterator = const_iterator;
+
+		roaring_bitmap() = default;
+
+		roaring_bitmap(const std::initializer_list<value_type> init)
+		{
+			for (const auto x : init) add(x);
+		}
+
+		void add(const value_type x)
+		{
+			chunk& c = chunk_for(x >> 16);
+			const auto low = static_cast<std::uint16_t>(x);
+			to_natural(c);
+			if (c.type == kind::bitmap)
+			{
+				c.card += !test(c, low);
+				set(c, low);
+				return;
+			}
+
+			const auto it = std::lower_bound(c.values.begin(), c.values.end(), low);
+			if (it != c.values.end() && *it == low) return;
+			c.values.insert(it, low);
+			if (++c.card > array_max) to_bitmap(c);
+		}
+
+		// Adds every value in [first, last)
+		void add_range(std::uint64_t first, const std::uint64_t last)
+		{
+			if (last > 0x1'0000'0000) throw std::out_of_range{"roaring_bitmap: range past 2^32"};
+			while (first < last)
+			{
+				const std::uint64_t chunk_end = std::min(last, (first | 0xffff) + 1);
+				chunk& c = chunk_for(static_cast<std::uint16_t>(first >> 16));
+				to_bitmap(c);
+				internal::FillBits(c.bits.words(), first & 0xffff, chunk_end - first, true);
+				c.card = static_cast<std::uint32_t>(c.bits.count());
+				if (c.card <= array_max) to_array(c);
+				first = chunk_end;
+			}
+		}
+
+		void remove(const value_type x)
+		{
+			const size_type i = find_chunk(x >> 16);
+			if (i == keys_.size()) return;
+
+			chunk& c = chunks_[i];
+			const auto low = static_cast<std::uint16_t>(x);
+			to_natural(c);
+			if (c.type == kind::bitmap)
+			{
+				if (!test(c, low)) return;
+				c.bits[low] = false;
+				if (--c.card <= array_max) to_array(c);
+			}
+			else
+			{
+				const auto it = std::lower_bound(c.values.begin(), c.values.end(), low);
+				if (it == c.values.end() || *it != low) return;
+				c.values.erase(it);
+				--c.card;
+			}
+
+			if (c.card == 0)
+			{
+				keys_.erase(keys_.begin() + i);
+				chunks_.erase(chunks_.begin() + i);
+			}
+		}
+
+		[[nodiscard]] bool contains(const value_type x) const noexcept
+		{
+			const size_type i = find_chunk(x >> 16);
+			return i != keys_.size() && contains(chunks_[i], static_cast<std::uint16_t>(x));
+		}
+
+		[[nodiscard]] size_type cardinality() const noexcept
+		{
+			size_type n = 0;
+			for (const auto& c : chunks_) n += c.card;
+			return n;
+		}
+
+		[[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+
+		void clear() noexcept
+		{
+			keys_.clear();
+			chunks_.clear();
+		}
+
+		roaring_bitmap& operator|=(const roaring_bitmap& x)
+		{
+			if (&x == this) return *this;
+
+			vector<std::uint16_t> keys;
+			vector<chunk> chunks;
+			keys.reserve(keys_.size() + x.keys_.size());
+			chunks.reserve(keys_.size() + x.keys_.size());
+
+			size_type i = 0, j = 0;
+			while (i < keys_.size() || j < x.keys_.size())
+			{
+				if (j == x.keys_.size() || (i < keys_.size() && keys_[i] < x.keys_[j]))
+				{
+					keys.push_back(keys_[i]);
+					chunks.push_back(std::move(chunks_[i++]));
+				}
+				else if (i == keys_.size() || x.keys_[j] < keys_[i])
+				{
+					keys.push_back(x.keys_[j]);
+					chunks.push_back(x.chunks_[j++]);
+				}
+				else
+				{
+					keys.push_back(keys_[i]);
+					chunks.push_back(std::move(chunks_[i++]));
+					unite(chunks.back(), x.chunks_[j++]);
+				}
+			}
+
+			keys_ = std::move(keys);
+			chunks_ = std::move(chunks);
+			return *this;
+		}
+
+		roaring_bitmap& operator&=(const roaring_bitmap& x)
+		{
+			if (&x == this) return *this;
+
+			size_type out = 0;
+			for (size_type i = 0, j = 0; i < keys_.size() && j < x.keys_.size();)
+			{
+				if (keys_[i] < x.keys_[j]) ++i;
+				else if (x.keys_[j] < keys_[i]) ++j;
+				else
+				{
+					intersect(chunks_[i], x.chunks_[j++]);
+					if (chunks_[i].card)
+					{
+						keys_[out] = keys_[i];
+						if (out != i) chunks_[out] = std::move(chunks_[i]);
+						++out;
+					}
+					++i;
+				}
+			}
+
+			keys_.resize(out);
+			chunks_.erase(chunks_.begin() + out, chunks_.end());
+			return *this;
+		}
+
+		// Stores each chunk in whichever of array, bitmap and runs takes the least space
+		void run_optimize()
+		{
+			for (auto& c : chunks_)
+			{
+				if (c.type == kind::run) continue;
+				const size_type runs = count_runs(c);
+				if (runs * 4 + 2 < std::min<size_type>(c.card * 2, bitmap_bytes)) to_runs(c, runs);
+			}
+		}
+
+		// Serialized form, all integers little-endian: u32 cookie, u32 chunk count, then for each chunk
+		// u16 key, u8 kind (0 array, 1 bitmap, 2 run) and u32 cardinality followed by its payload: the
+		// values as u16 for arrays, 8192 bytes (bit i in byte i / 8) for bitmaps, or a u16 run count
+		// and (start, length - 1) u16 pairs for runs.
+		void serialize(std::ostream& os) const
+		{
+			put(os, cookie, 4);
+			put(os, keys_.size(), 4);
+			for (size_type i = 0; i < keys_.size(); ++i)
+			{
+				const chunk& c = chunks_[i];
+				put(os, keys_[i], 2);
+				put(os, static_cast<std::uint64_t>(c.type), 1);
+				put(os, c.card, 4);
+				if (c.type == kind::bitmap)
+				{
+					for (size_type w = 0; w < bitmap_words; ++w) put(os, c.bits.words()[w], sizeof(internal::Word));
+				}
+				else
+				{
+					if (c.type == kind::run) put(os, c.values.size() / 2, 2);
+					for (const auto v : c.values) put(os, v, 2);
+				}
+			}
+		}
+
+		[[nodiscard]] static roaring_bitmap deserialize(std::istream& is)
+		{
+			if (get(is, 4) != cookie) throw std::invalid_argument{"roaring_bitmap: bad cookie"};
+
+			roaring_bitmap r;
+			const auto n = get(is, 4);
+			for (std::uint64_t i = 0; i < n; ++i)
+			{
+				const auto key = static_cast<std::uint16_t>(get(is, 2));
+				if (!r.keys_.empty() && key <= r.keys_.back()) throw std::invalid_argument{"roaring_bitmap: unsorted keys"};
+
+				chunk c;
+				c.type = static_cast<kind>(get(is, 1));
+				c.card = static_cast<std::uint32_t>(get(is, 4));
+				if (c.card == 0 || c.card > 0x10000) throw std::invalid_argument{"roaring_bitmap: bad cardinality"};
+
+				switch (c.type)
+				{
+				case kind::array:
+					if (c.card > array_max) throw std::invalid_argument{"roaring_bitmap: oversized array"};
+					c.values.resize_for_overwrite(c.card);
+					for (auto& v : c.values) v = static_cast<std::uint16_t>(get(is, 2));
+					break;
+				case kind::bitmap:
+					c.bits.resize(0x10000);
+					for (size_type w = 0; w < bitmap_words; ++w)
+						c.bits.words()[w] = static_cast<internal::Word>(get(is, sizeof(internal::Word)));
+					break;
+				case kind::run:
+					c.values.resize_for_overwrite(get(is, 2) * 2);
+					for (auto& v : c.values) v = static_cast<std::uint16_t>(get(is, 2));
+					break;
+				default:
+					throw std::invalid_argument{"roaring_bitmap: bad container kind"};
+				}
+				if (!valid(c)) throw std::invalid_argument{"roaring_bitmap: corrupt container"};
+
+				r.keys_.push_back(key);
+				r.chunks_.push_back(std::move(c));
+			}
+			return r;
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator{this, 0}; }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator{this, keys_.size()}; }
+
+		[[nodiscard]] friend bool operator==(const roaring_bitmap& lhs, const roaring_bitmap& rhs) noexcept
+		{
+			return lhs.keys_ == rhs.keys_ && lhs.cardinality() == rhs.cardinality()
+				&& std::equal(lhs.begin(), lhs.end(), rhs.begin());
+		}
+
+		[[nodiscard]] friend bool operator!=(const roaring_bitmap& lhs, const roaring_bitmap& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		enum class kind : unsigned char { array, bitmap, run };
+
+		struct chunk
+		{
+			kind type = kind::array;
+			std::uint32_t card = 0;
+			vector<std::uint16_t> values; // array: sorted values; run: (start, length - 1) pairs
+			vector<bool> bits;            // bitmap: 2^16 bits
+		};
+
+		static constexpr std::uint32_t array_max = 4096;
+		static constexpr size_type bitmap_bytes = 0x10000 / 8;
+		static constexpr size_type bitmap_words = bitmap_bytes / sizeof(internal::Word);
+		static constexpr std::uint64_t cookie = 0x31425230; // "0RB1"
+
+	public:
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::uint32_t;
+			using difference_type = ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = value_type;
+
+			const_iterator() = default;
+
+			[[nodiscard]] value_type operator*() const noexcept
+			{
+				return static_cast<value_type>(owner_->keys_[chunk_]) << 16 | low_;
+			}
+
+			const_iterator& operator++() noexcept
+			{
+				const chunk& c = owner_->chunks_[chunk_];
+				switch (c.type)
+				{
+				case kind::array:
+					if (++pos_ < c.card) low_ = c.values[pos_];
+					else enter(chunk_ + 1);
+					break;
+				case kind::bitmap:
+				{
+					const auto next = c.bits.find_next(low_);
+					if (next != vector<bool>::npos) low_ = static_cast<std::uint32_t>(next);
+					else enter(chunk_ + 1);
+					break;
+				}
+				case kind::run:
+					if (low_ < static_cast<std::uint32_t>(c.values[pos_]) + c.values[pos_ + 1]) ++low_;
+					else if ((pos_ += 2) < c.values.size()) low_ = c.values[pos_];
+					else enter(chunk_ + 1);
+					break;
+				}
+				return *this;
+			}
+
+			const_iterator operator++(int) noexcept
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const noexcept
+			{
+				return chunk_ == rhs.chunk_ && pos_ == rhs.pos_ && low_ == rhs.low_;
+			}
+
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const noexcept { return !(*this == rhs); }
+
+		private:
+			friend roaring_bitmap;
+
+			const_iterator(const roaring_bitmap* owner, const size_type chunk) noexcept : owner_{owner}
+			{
+				enter(chunk);
+			}
+
+			void enter(const size_type chunk) noexcept
+			{
+				chunk_ = chunk;
+				pos_ = 0;
+				low_ = 0;
+				if (chunk_ == owner_->keys_.size()) return;
+
+				const auto& c = owner_->chunks_[chunk_];
+				low_ = c.type == kind::bitmap ? static_cast<std::uint32_t>(c.bits.find_first()) : c.values[0];
+			}
+
+			const roaring_bitmap* owner_ = nullptr;
+			size_type chunk_ = 0;
+			size_type pos_ = 0; // array index, or index of the current run's start
+			std::uint32_t low_ = 0;
+		};
+
+	private:
+		[[nodiscard]] size_type find_chunk(const std::uint16_t key) const noexcept
+		{
+			const auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+			return it != keys_.end() && *it == key ? static_cast<size_type>(it - keys_.begin()) : keys_.size();
+		}
+
+		chunk& chunk_for(const std::uint16_t key)
+		{
+			const auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+			const auto i = static_cast<size_type>(it - keys_.begin());
+			if (it == keys_.end() || *it != key)
+			{
+				keys_.insert(it, key);
+				chunks_.insert(chunks_.begin() + i, chunk{});
+			}
+			return chunks_[i];
+		}
+
+		[[nodiscard]] static bool test(const chunk& c, const std::uint16_t low) noexcept
+		{
+			return c.bits.words()[low / internal::word_bits] >> low % internal::word_bits & 1;
+		}
+
+		static void set(chunk& c, const std::uint16_t low) noexcept
+		{
+			c.bits.words()[low / internal::word_bits] |= internal::Word{1} << low % internal::word_bits;
+		}
+
+		[[nodiscard]] static bool contains(const chunk& c, const std::uint16_t low) noexcept
+		{
+			switch (c.type)
+			{
+			case kind::array:
+				return std::binary_search(c.values.begin(), c.values.end(), low);
+			case kind::bitmap:
+				return test(c, low);
+			default:
+			{
+				// Last run starting at or before low
+				size_type lo = 0, n = c.values.size() / 2;
+				if (n == 0 || c.values[0] > low) return false;
+				while (n > 1)
+				{
+					const size_type half = n / 2;
+					if (c.values[(lo + half) * 2] <= low)
+					{
+						lo += half;
+						n -= half;
+					}
+					else n = half;
+				}
+				return low - c.values[lo * 2] <= c.values[lo * 2 + 1];
+			}
+			}
+		}
+
+		// Array values strictly increase; runs are non-empty, stay within the chunk and do not overlap; and
+		// the stored cardinality matches the contents
+		[[nodiscard]] static bool valid(const chunk& c)
+		{
+			switch (c.type)
+			{
+			case kind::array:
+				return std::adjacent_find(c.values.begin(), c.values.end(), std::greater_equal<>{}) == c.values.end();
+			case kind::bitmap:
+				return c.bits.count() == c.card;
+			default:
+			{
+				if (c.values.empty()) return false;
+				std::uint32_t card = 0, next = 0;
+				for (size_type r = 0; r < c.values.size(); r += 2)
+				{
+					const std::uint32_t start = c.values[r], last = start + c.values[r + 1];
+					if (start < next || last > 0xffff) return false;
+					card += c.values[r + 1] + 1;
+					next = last + 1;
+				}
+				return card == c.card;
+			}
+			}
+		}
+
+		static void to_bitmap(chunk& c)
+		{
+			if (c.type == kind::bitmap) return;
+
+			vector<bool> bits(0x10000, false);
+			if (c.type == kind::array)
+			{
+				for (const auto v : c.values) bits.words()[v / internal::word_bits] |= internal::Word{1} << v % internal::word_bits;
+			}
+			else
+			{
+				for (size_type r = 0; r < c.values.size(); r += 2)
+					internal::FillBits(bits.words(), c.values[r], size_type{c.values[r + 1]} + 1, true);
+			}
+
+			c.type = kind::bitmap;
+			c.bits = std::move(bits);
+			c.values = {};
+		}
+
+		static void to_array(chunk& c)
+		{
+			if (c.type == kind::array) return;
+
+			vector<std::uint16_t> values;
+			values.reserve(c.card);
+			if (c.type == kind::bitmap)
+			{
+				for (auto i = c.bits.find_first(); i != vector<bool>::npos; i = c.bits.find_next(i))
+					values.push_back(static_cast<std::uint16_t>(i));
+			}
+			else
+			{
+				for (size_type r = 0; r < c.values.size(); r += 2)
+					for (std::uint32_t v = c.values[r], e = v + c.values[r + 1]; v <= e; ++v)
+						values.push_back(static_cast<std::uint16_t>(v));
+			}
+
+			c.type = kind::array;
+			c.values = std::move(values);
+			c.bits = {};
+		}
+
+		static void to_natural(chunk& c)
+		{
+			if (c.type != kind::run) return;
+			if (c.card <= array_max) to_array(c);
+			else to_bitmap(c);
+		}
+
+		[[nodiscard]] static size_type count_runs(const chunk& c) noexcept
+		{
+			size_type runs = 0;
+			if (c.type == kind::array)
+			{
+				for (size_type i = 0; i < c.card; ++i)
+					runs += i == 0 || c.values[i] != c.values[i - 1] + 1;
+			}
+			else
+			{
+				// A run starts at every set bit whose lower neighbour is clear
+				internal::Word carry = 0;
+				for (size_type w = 0; w < bitmap_words; ++w)
+				{
+					const internal::Word x = c.bits.words()[w];
+					runs += std::popcount(x & ~(x << 1 | carry));
+					carry = x >> (internal::word_bits - 1);
+				}
+			}
+			return runs;
+		}
+
+		static void to_runs(chunk& c, const size_type runs)
+		{
+			to_array(c);
+			vector<std::uint16_t> pairs;
+			pairs.reserve(runs * 2);
+			for (size_type i = 0; i < c.card;)
+			{
+				size_type j = i + 1;
+				while (j < c.card && c.values[j] == c.values[j - 1] + 1) ++j;
+				pairs.push_back(c.values[i]);
+				pairs.push_back(static_cast<std::uint16_t>(j - i - 1));
+				i = j;
+			}
+
+			c.type = kind::run;
+			c.values = std::move(pairs);
+		}
+
+		static void unite(chunk& a, const chunk& b)
+		{
+			if (b.type == kind::run)
+			{
+				chunk natural = b;
+				to_natural(natural);
+				return unite(a, natural);
+			}
+
+			to_natural(a);
+			if (a.type == kind::array && b.type == kind::array)
+			{
+				vector<std::uint16_t> values;
+				values.reserve(a.card + b.card);
+				std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(values));
+				a.values = std::move(values);
+				a.card = static_cast<std::uint32_t>(a.values.size());
+				if (a.card > array_max) to_bitmap(a);
+				return;
+			}
+
+			to_bitmap(a);
+			if (b.type == kind::bitmap) a.bits |= b.bits;
+			else for (const auto v : b.values) set(a, v);
+			a.card = static_cast<std::uint32_t>(a.bits.count());
+		}
+
+		static void intersect(chunk& a, const chunk& b)
+		{
+			if (b.type == kind::run)
+			{
+				chunk natural = b;
+				to_natural(natural);
+				return intersect(a, natural);
+			}
+
+			to_natural(a);
+			if (a.type == kind::bitmap && b.type == kind::bitmap)
+			{
+				a.bits &= b.bits;
+				a.card = static_cast<std::uint32_t>(a.bits.count());
+				if (a.card <= array_max) to_array(a);
+				return;
+			}
+
+			vector<std::uint16_t> values;
+			if (a.type == kind::array && b.type == kind::array)
+			{
+				values.reserve(std::min(a.card, b.card));
+				std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(values));
+			}
+			else
+			{
+				const chunk& arr = a.type == kind::array ? a : b;
+				const chunk& bmp = a.type == kind::array ? b : a;
+				values.reserve(arr.card);
+				for (const auto v : arr.values)
+					if (test(bmp, v)) values.push_back(v);
+			}
+
+			a.type = kind::array;
+			a.values = std::move(values);
+			a.bits = {};
+			a.card = static_cast<std::uint32_t>(a.values.size());
+		}
+
+		static void put(std::ostream& os, std::uint64_t v, const int bytes)
+		{
+			char buf[8];
+			for (auto i = 0; i < bytes; ++i, v >>= 8) buf[i] = static_cast<char>(v & 0xff);
+			os.write(buf, bytes);
+		}
+
+		[[nodiscard]] static std::uint64_t get(std::istream& is, const int bytes)
+		{
+			unsigned char buf[8];
+			if (!is.read(reinterpret_cast<char*>(buf), bytes)) throw std::invalid_argument{"roaring_bitmap: truncated input"};
+			std::uint64_t v = 0;
+			for (auto i = bytes; i--;) v = v << 8 | buf[i];
+			return v;
+		}
+
+		vector<std::uint16_t> keys_;
+		vector<chunk> chunks_;
+	};
+
+	[[nodiscard]] inline roaring_bitmap operator|(roaring_bitmap lhs, const roaring_bitmap& rhs)
+	{
+		return lhs |= rhs;
+	}
+
+	[[nodiscard]] inline roaring_bitmap operator&(roaring_bitmap lhs, const roaring_bitmap& rhs)
+	{
+		return lhs &= rhs;
+	}
+}
@@ -0,0 +1,587 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "vector.h"
+
+namespace ostl
+{
+	// A vector of rows stored column by column: each field has its own contiguous array, so a loop over one
+	// field streams only that field. All columns live in one allocation, each starting on a 64-byte boundary,
+	// and share one size and capacity. column<I>() gives a span over a field; iterators zip the columns and
+	// yield tuples of references. Columns of trivially relocatable types are moved with memcpy/memmove.
+	template <class... Ts>
+	class soa_vector
+	{
+		static_assert(sizeof...(Ts) > 0);
+
+	public:
+		using value_type = std::tuple<Ts...>;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = std::tuple<Ts&...>;
+		using const_reference = std::tuple<const Ts&...>;
+
+		template <size_t I>
+		using column_type = std::tuple_element_t<I, value_type>;
+
+		static constexpr size_type column_alignment = 64;
+
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename soa_vector::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = void;
+			using reference = const_reference;
+
+			const_iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return Row<reference>(cols_, idx_); }
+			[[nodiscard]] reference operator[](const difference_type n) const { return Row<reference>(cols_, idx_ + n); }
+
+			const_iterator& operator++() { return *this += 1; }
+
+			const_iterator operator++(int)
+			{
+				const auto it = *this;
+				++*this;
+				return it;
+			}
+
+			const_iterator& operator--() { return *this -= 1; }
+
+			const_iterator operator--(int)
+			{
+				const auto it = *this;
+				--*this;
+				return it;
+			}
+
+			const_iterator& operator+=(const difference_type n)
+			{
+				idx_ += n;
+				return *this;
+			}
+
+			[[nodiscard]] const_iterator operator+(const difference_type n) const
+			{
+				const_iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			const_iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] const_iterator operator-(const difference_type n) const { return *this + -n; }
+
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const
+			{
+				return static_cast<difference_type>(idx_ - rhs.idx_);
+			}
+
+			[[nodiscard]] bool operator==(const const_iterator& rhs) const { return idx_ == rhs.idx_; }
+			[[nodiscard]] bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+			[[nodiscard]] bool operator<(const const_iterator& rhs) const { return idx_ < rhs.idx_; }
+			[[nodiscard]] bool operator>(const const_iterator& rhs) const { return rhs < *this; }
+			[[nodiscard]] bool operator>=(const const_iterator& rhs) const { return !(*this < rhs); }
+			[[nodiscard]] bool operator<=(const const_iterator& rhs) const { return !(*this > rhs); }
+
+		protected:
+			friend soa_vector;
+
+			const_iterator(const std::tuple<Ts*...>& cols, const size_type idx) : cols_{cols}, idx_{idx}
+			{
+			}
+
+			std::tuple<Ts*...> cols_;
+			size_type idx_ = 0;
+		};
+
+		class iterator : public const_iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = typename soa_vector::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = void;
+			using reference = typename soa_vector::reference;
+
+			iterator() = default;
+
+			[[nodiscard]] reference operator*() const { return Row<reference>(this->cols_, this->idx_); }
+			[[nodiscard]] reference operator[](const difference_type n) const { return Row<reference>(this->cols_, this->idx_ + n); }
+
+			iterator& operator++() { return *this += 1; }
+
+			iterator operator++(int)
+			{
+				iterator it = *this;
+				++*this;
+				return it;
+			}
+
+			iterator& operator--() { return *this -= 1; }
+
+			iterator operator--(int)
+			{
+				iterator it = *this;
+				--*this;
+				return it;
+			}
+
+			iterator& operator+=(const difference_type n)
+			{
+				const_iterator::operator+=(n);
+				return *this;
+			}
+
+			[[nodiscard]] iterator operator+(const difference_type n) const
+			{
+				iterator it = *this;
+				it += n;
+				return it;
+			}
+
+			iterator& operator-=(const difference_type n) { return *this += -n; }
+			[[nodiscard]] iterator operator-(const difference_type n) const { return *this + -n; }
+			[[nodiscard]] difference_type operator-(const const_iterator& rhs) const { return const_iterator::operator-(rhs); }
+
+		private:
+			friend soa_vector;
+
+			iterator(const std::tuple<Ts*...>& cols, const size_type idx) : const_iterator{cols, idx}
+			{
+			}
+		};
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		soa_vector() = default;
+
+		explicit soa_vector(const size_type n) { resize(n); }
+		soa_vector(const size_type n, const value_type& value) { resize(n, value); }
+
+		soa_vector(const std::initializer_list<value_type> init)
+		{
+			reserve(init.size());
+			for (const auto& row : init) push_back(row);
+		}
+
+		// Copies column by column, straight into place
+		soa_vector(const soa_vector& x)
+		{
+			reserve(x.size_);
+			size_t built = 0;
+			try
+			{
+				ForEachColumn([&](auto i)
+				{
+					std::uninitialized_copy_n(std::get<i>(x.cols_), x.size_, std::get<i>(cols_));
+					++built;
+				});
+			}
+			catch (...)
+			{
+				ForEachColumn([&](auto i)
+				{
+					if (i < built) std::destroy_n(std::get<i>(cols_), x.size_);
+				});
+				deallocate(block_, capacity_);
+				throw;
+			}
+			size_ = x.size_;
+		}
+
+		soa_vector(soa_vector&& x) noexcept
+			: block_{std::exchange(x.block_, nullptr)}, cols_{std::exchange(x.cols_, {})},
+			  size_{std::exchange(x.size_, 0)}, capacity_{std::exchange(x.capacity_, 0)}
+		{
+		}
+
+		~soa_vector()
+		{
+			clear();
+			deallocate(block_, capacity_);
+		}
+
+		soa_vector& operator=(const soa_vector& x)
+		{
+			if (this != &x) soa_vector{x}.swap(*this);
+			return *this;
+		}
+
+		soa_vector& operator=(soa_vector&& x) noexcept
+		{
+			soa_vector{std::move(x)}.swap(*this);
+			return *this;
+		}
+
+		template <size_t I>
+		[[nodiscard]] column_type<I>* data() noexcept { return std::get<I>(cols_); }
+
+		template <size_t I>
+		[[nodiscard]] const column_type<I>* data() const noexcept { return std::get<I>(cols_); }
+
+		// One field of every row, contiguous and 64-byte aligned
+		template <size_t I>
+		[[nodiscard]] std::span<column_type<I>> column() noexcept { return {data<I>(), size_}; }
+
+		template <size_t I>
+		[[nodiscard]] std::span<const column_type<I>> column() const noexcept { return {data<I>(), size_}; }
+
+		[[nodiscard]] reference at(const size_type n)
+		{
+			if (n >= size_) throw std::out_of_range{""};
+			return (*this)[n];
+		}
+
+		[[nodiscard]] const_reference at(const size_type n) const
+		{
+			if (n >= size_) throw std::out_of_range{""};
+			return (*this)[n];
+		}
+
+		[[nodiscard]] reference operator[](const size_type n) { return Row<reference>(cols_, n); }
+		[[nodiscard]] const_reference operator[](const size_type n) const { return Row<const_reference>(cols_, n); }
+		[[nodiscard]] reference front() { return (*this)[0]; }
+		[[nodiscard]] const_reference front() const { return (*this)[0]; }
+		[[nodiscard]] reference back() { return (*this)[size_ - 1]; }
+		[[nodiscard]] const_reference back() const { return (*this)[size_ - 1]; }
+
+		[[nodiscard]] iterator begin() noexcept { return {cols_, 0}; }
+		[[nodiscard]] const_iterator begin() const noexcept { return {cols_, 0}; }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+
+		[[nodiscard]] iterator end() noexcept { return {cols_, size_}; }
+		[[nodiscard]] const_iterator end() const noexcept { return {cols_, size_}; }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{cend()}; }
+
+		[[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return const_reverse_iterator{cbegin()}; }
+
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+		[[nodiscard]] size_type size() const noexcept { return size_; }
+		[[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+		[[nodiscard]] static size_type max_size() noexcept { return std::numeric_limits<difference_type>::max() / (row_bytes + 1); }
+
+		void reserve(const size_type n)
+		{
+			if (n > capacity_) reallocate(n);
+		}
+
+		void shrink_to_fit()
+		{
+			if (size_ < capacity_) reallocate(size_);
+		}
+
+		void clear() noexcept
+		{
+			destroy(0, size_);
+			size_ = 0;
+		}
+
+		void push_back(const value_type& row)
+		{
+			std::apply([this](const Ts&... x) { emplace_back(x...); }, row);
+		}
+
+		void push_back(value_type&& row)
+		{
+			std::apply([this](Ts&... x) { emplace_back(std::move(x)...); }, row);
+		}
+
+		// Takes one constructor argument per column
+		template <class... Args>
+		reference emplace_back(Args&&... args)
+		{
+			static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back takes one argument per column");
+			if (size_ == capacity_) grow_emplace_back(std::forward<Args>(args)...);
+			else ConstructRow(cols_, size_, std::forward<Args>(args)...);
+			return (*this)[size_++];
+		}
+
+		iterator insert(const const_iterator position, const value_type& row)
+		{
+			const size_type idx = position.idx_;
+			if (idx == size_)
+			{
+				push_back(row);
+				return begin() + idx;
+			}
+
+			value_type copy{row};
+			reserve(new_cap(size_ + 1));
+			Relocate(cols_, idx, cols_, idx + 1, size_ - idx);
+			try
+			{
+				std::apply([&](Ts&... x) { ConstructRow(cols_, idx, std::move(x)...); }, copy);
+			}
+			catch (...)
+			{
+				// construct_row left row idx unconstructed; close the gap again
+				Relocate(cols_, idx + 1, cols_, idx, size_ - idx);
+				throw;
+			}
+			++size_;
+			return begin() + idx;
+		}
+
+		void pop_back()
+		{
+			destroy(size_ - 1, size_);
+			--size_;
+		}
+
+		iterator erase(const const_iterator position) { return erase(position, position + 1); }
+
+		iterator erase(const const_iterator first, const const_iterator last)
+		{
+			const size_type f = first.idx_, l = last.idx_;
+			destroy(f, l);
+			Relocate(cols_, l, cols_, f, size_ - l);
+			size_ -= l - f;
+			return begin() + f;
+		}
+
+		void resize(const size_type n)
+		{
+			if (n > size_)
+			{
+				reserve(n);
+				while (size_ < n) emplace_back(Ts{}...);
+			}
+			else
+			{
+				erase(cbegin() + n, cend());
+			}
+		}
+
+		void resize(const size_type n, const value_type& value)
+		{
+			if (n > size_)
+			{
+				reserve(n);
+				while (size_ < n) push_back(value);
+			}
+			else
+			{
+				erase(cbegin() + n, cend());
+			}
+		}
+
+		void swap(soa_vector& x) noexcept
+		{
+			using std::swap;
+			swap(block_, x.block_);
+			swap(cols_, x.cols_);
+			swap(size_, x.size_);
+			swap(capacity_, x.capacity_);
+		}
+
+	private:
+		using columns = std::tuple<Ts*...>;
+		using indices = std::index_sequence_for<Ts...>;
+
+		static constexpr size_type row_bytes = (sizeof(Ts) + ...);
+
+		template <class R, size_t... I>
+		[[nodiscard]] static R Row(const columns& cols, const size_type i, std::index_sequence<I...>) noexcept
+		{
+			return R{std::get<I>(cols)[i]...};
+		}
+
+		template <class R>
+		[[nodiscard]] static R Row(const columns& cols, const size_type i) noexcept { return Row<R>(cols, i, indices{}); }
+
+		// Calls f(std::integral_constant<size_t, I>) for every column I
+		template <class F, size_t... I>
+		static void ForEachColumn(F&& f, std::index_sequence<I...>) { (f(std::integral_constant<size_t, I>{}), ...); }
+
+		template <class F>
+		static void ForEachColumn(F&& f) { ForEachColumn(std::forward<F>(f), indices{}); }
+
+		[[nodiscard]] static constexpr size_type RoundUp(const size_type n) noexcept
+		{
+			return (n + (column_alignment - 1)) & ~(column_alignment - 1);
+		}
+
+		// Bytes of a block holding n rows; its columns start at Offset(n, I)
+		[[nodiscard]] static size_type BlockBytes(const size_type n) noexcept
+		{
+			size_type bytes = 0;
+			ForEachColumn([&](auto i) { bytes = RoundUp(bytes) + n * sizeof(column_type<i>); });
+			return RoundUp(bytes);
+		}
+
+		[[nodiscard]] static columns Columns(std::byte* block, const size_type n) noexcept
+		{
+			columns cols;
+			size_type offset = 0;
+			ForEachColumn([&](auto i)
+			{
+				offset = RoundUp(offset);
+				std::get<i>(cols) = reinterpret_cast<column_type<i>*>(block + offset);
+				offset += n * sizeof(column_type<i>);
+			});
+			return cols;
+		}
+
+		[[nodiscard]] static std::byte* allocate(const size_type n)
+		{
+			if (n > max_size()) throw std::length_error{""};
+			return static_cast<std::byte*>(::operator new(BlockBytes(n), std::align_val_t{column_alignment}));
+		}
+
+		static void deallocate(std::byte* block, size_type) noexcept
+		{
+			if (block) ::operator delete(block, std::align_val_t{column_alignment});
+		}
+
+		template <size_t... I, class... Args>
+		static void ConstructRow(std::index_sequence<I...>, const columns& cols, const size_type i, Args&&... args)
+		{
+			size_t built = 0;
+			try
+			{
+				((::new(static_cast<void*>(std::get<I>(cols) + i)) column_type<I>(std::forward<Args>(args)), ++built), ...);
+			}
+			catch (...)
+			{
+				ForEachColumn([&](auto c)
+				{
+					if (c < built) std::destroy_at(std::get<c>(cols) + i);
+				});
+				throw;
+			}
+		}
+
+		// Constructs row i from one argument per column; a column that throws undoes the ones before it
+		template <class... Args>
+		static void ConstructRow(const columns& cols, const size_type i, Args&&... args)
+		{
+			ConstructRow(indices{}, cols, i, std::forward<Args>(args)...);
+		}
+
+		void destroy(const size_type first, const size_type last) noexcept
+		{
+			ForEachColumn([&](auto i)
+			{
+				using T = column_type<i>;
+				if constexpr (!std::is_trivially_destructible_v<T>)
+					std::destroy(std::get<i>(cols_) + first, std::get<i>(cols_) + last);
+			});
+		}
+
+		// Moves rows [src, src + count) of from to the uninitialized rows at dst of to, which may overlap
+		static void Relocate(const columns& from, const size_type src, const columns& to, const size_type dst, const size_type count)
+		{
+			if (count == 0) return;
+			ForEachColumn([&](auto i)
+			{
+				using T = column_type<i>;
+				T* const s = std::get<i>(from) + src;
+				T* const d = std::get<i>(to) + dst;
+				if (s == d) return;
+
+				if constexpr (internal::CanRelocate<T, std::allocator<T>>)
+				{
+					std::memmove(static_cast<void*>(d), static_cast<const void*>(s), count * sizeof(T));
+				}
+				else if (d < s)
+				{
+					for (size_type k = 0; k < count; ++k)
+					{
+						::new(static_cast<void*>(d + k)) T(std::move(s[k]));
+						std::destroy_at(s + k);
+					}
+				}
+				else
+				{
+					for (size_type k = count; k--;)
+					{
+						::new(static_cast<void*>(d + k)) T(std::move(s[k]));
+						std::destroy_at(s + k);
+					}
+				}
+			});
+		}
+
+		// One capacity decision for every column, made as if the rows were one struct
+		[[nodiscard]] size_type new_cap(const size_type required) const noexcept
+		{
+			return required <= capacity_ ? capacity_ : growth::geometric<>::next_capacity(capacity_, required, row_bytes);
+		}
+
+		void reallocate(const size_type n)
+		{
+			std::byte* const block = allocate(n);
+			const columns cols = Columns(block, n);
+			Relocate(cols_, 0, cols, 0, size_);
+			deallocate(block_, capacity_);
+			block_ = block;
+			cols_ = cols;
+			capacity_ = n;
+		}
+
+		// Constructs the new row before relocating so that args may alias existing rows
+		template <class... Args>
+		OSTL_NOINLINE void grow_emplace_back(Args&&... args)
+		{
+			const size_type n = new_cap(size_ + 1);
+			std::byte* const block = allocate(n);
+			const columns cols = Columns(block, n);
+			try
+			{
+				ConstructRow(cols, size_, std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				deallocate(block, n);
+				throw;
+			}
+			Relocate(cols_, 0, cols, 0, size_);
+			deallocate(block_, capacity_);
+			block_ = block;
+			cols_ = cols;
+			capacity_ = n;
+		}
+
+		std::byte* block_ = nullptr;
+		columns cols_{};
+		size_type size_ = 0;
+		size_type capacity_ = 0;
+	};
+
+	template <class... Ts>
+	[[nodiscard]] bool operator==(const soa_vector<Ts...>& lhs, const soa_vector<Ts...>& rhs)
+	{
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template <class... Ts>
+	[[nodiscard]] bool operator!=(const soa_vector<Ts...>& lhs, const soa_vector<Ts...>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <class... Ts>
+	void swap(soa_vector<Ts...>& lhs, soa_vector<Ts...>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+}
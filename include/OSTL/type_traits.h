@@ -0,0 +1,15 @@
+#pragma once
+
+#include <type_traits>
+
+namespace ostl
+{
+	// Specialize as std::true_type for types that can be moved by memcpy and then forgotten.
+	template <class T>
+	struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+	{
+	};
+
+	template <class T>
+	inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+}
@@ -1,17 +1,94 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <memory_resource>
+#include <ranges>
 #include "internal/iterator.h"
 #include "internal/compressed_pair.h"
+#include "internal/alloc_traits.h"
+#include "internal/bit_expr.h"
+#include "internal/bits.h"
+#include "internal/config.h"
 
 namespace ostl
 {
-	template <class T, class Alloc = std::allocator<T>>
-	class vector
+	namespace growth
 	{
+		// new = max(required, cap * Num / Den)
+		template <size_t Num = 3, size_t Den = 2>
+		struct geometric
+		{
+			static_assert(Num > Den, "growth factor must be greater than 1");
+
+			[[nodiscard]] static constexpr size_t next_capacity(const size_t cap, const size_t required, size_t) noexcept
+			{
+				return std::max(required, cap + std::max<size_t>(cap * (Num - Den) / Den, 1));
+			}
+		};
+
+		using doubling = geometric<2, 1>;
+
+		// At least doubles, rounding the block size up to a power of two bytes
+		struct power_of_two
+		{
+			[[nodiscard]] static constexpr size_t next_capacity(const size_t cap, const size_t required, const size_t elem_size) noexcept
+			{
+				return std::bit_ceil(std::max(required, std::max<size_t>(cap * 2, 1)) * elem_size) / elem_size;
+			}
+		};
+
+		// Grows by half, but never by more than MaxStep bytes at once
+		template <size_t MaxStep = 64 * 1024 * 1024>
+		struct capped_linear
+		{
+			[[nodiscard]] static constexpr size_t next_capacity(const size_t cap, const size_t required, const size_t elem_size) noexcept
+			{
+				const size_t step = std::clamp<size_t>(cap / 2, 1, std::max<size_t>(MaxStep / elem_size, 1));
+				return std::max(required, cap + step);
+			}
+		};
+
+		// Grows like Base, but tries to extend the block in place with realloc first.
+		// Only takes effect for trivially relocatable types with malloc_allocator.
+		template <class Base = geometric<>>
+		struct in_place : Base
+		{
+			static constexpr bool try_in_place = true;
+		};
+	}
+
+	namespace internal
+	{
+		template <class Growth, class = void>
+		struct TriesInPlace : std::false_type {};
+
+		template <class Growth>
+		struct TriesInPlace<Growth, std::void_t<decltype(Growth::try_in_place)>> : std::bool_constant<Growth::try_in_place> {};
+
+		template <class T, size_t N>
+		struct InlineStorage
+		{
+			alignas(T) unsigned char buffer[N * sizeof(T)];
+		};
+
+		template <class T>
+		struct InlineStorage<T, 0>
+		{
+		};
+	}
+
+	// N > 0 keeps up to N elements inline before spilling to the heap (see small_vector)
+	template <class T, class Alloc = std::allocator<T>, class Growth = growth::geometric<>, size_t N = 0>
+	class vector : internal::InlineStorage<T, N>
+	{
+		static_assert(N == 0 || std::is_pointer_v<typename std::allocator_traits<Alloc>::pointer>,
+			"inline storage requires raw pointers");
+
 	public:
 		using value_type = T;
 		using allocator_type = Alloc;
@@ -33,17 +110,16 @@ namespace ostl
 		}
 
 		vector(size_type n, const T& value, const Alloc& alloc = Alloc{})
-			: r_{internal::ZeroThen{}, alloc}, capacity_{n}, size_{n}
+			: r_{internal::ZeroThen{}, alloc}, size_{n}
 		{
-			r_.first = std::allocator_traits<Alloc>::allocate(r_.second, n);
-			for (size_type i = 0; i < size_; ++i)
-				std::allocator_traits<Alloc>::construct(r_.second, r_.first + i, value);
+			allocate(n);
+			fill(r_.first, n, value);
 		}
 
 		explicit vector(size_type n, const Alloc& alloc = Alloc{})
-			: r_{internal::ZeroThen{}, alloc}, capacity_{n}, size_{n}
+			: r_{internal::ZeroThen{}, alloc}, size_{n}
 		{
-			r_.first = std::allocator_traits<Alloc>::allocate(r_.second, n);
+			allocate(n);
 			for (size_type i = 0; i < size_; ++i)
 				std::allocator_traits<Alloc>::construct(r_.second, r_.first + i);
 		}
@@ -56,42 +132,35 @@ namespace ostl
 		vector(InputIt first, InputIt last, const Alloc& alloc = Alloc{})
 			: r_{internal::ZeroThen{}, alloc}
 		{
-			reserve(std::distance(first, last));
-			for (InputIt it = first; it != last; ++it)
-				emplace_back(*it);
+			if constexpr (internal::IsForwardIterator<InputIt>)
+				reserve(std::distance(first, last));
+			insert(cend(), first, last);
 		}
 
 		vector(const vector& x)
-			: r_{internal::ZeroThen{}, x.r_.second}, capacity_{x.size_}, size_{x.size_}
+			: r_{internal::ZeroThen{}, x.r_.second}, size_{x.size_}
 		{
-			pointer p = r_.first = std::allocator_traits<Alloc>::allocate(r_.second, size_);
-			for (const value_type& a : x)
-				std::allocator_traits<Alloc>::construct(r_.second, p++, a);
+			allocate(size_);
+			copy(r_.first, x.r_.first, size_);
 		}
 
 		vector(const vector& x, const Alloc& alloc)
-			: r_{internal::ZeroThen{}, alloc}, capacity_{x.size_}, size_{x.size_}
+			: r_{internal::ZeroThen{}, alloc}, size_{x.size_}
 		{
-			r_.first = std::allocator_traits<Alloc>::allocate(r_.second, size_);
-			pointer p = r_.first;
-			for (const value_type& a : x)
-				std::allocator_traits<Alloc>::construct(r_.second, p++, a);
+			allocate(size_);
+			copy(r_.first, x.r_.first, size_);
 		}
 
-		vector(vector&& x) noexcept
-			: r_{internal::OneThen{}, x.r_.first, std::move(x.r_.second)}, capacity_{x.capacity_}, size_{x.size_}
+		vector(vector&& x) noexcept(N == 0 || std::is_nothrow_move_constructible_v<T>)
+			: r_{internal::ZeroThen{}, std::move(x.r_.second)}
 		{
-			x.r_.first = nullptr;
-			x.capacity_ = 0;
-			x.size_ = 0;
+			steal(x);
 		}
 
 		vector(vector&& x, const Alloc& alloc)
-			: r_{internal::OneThen{}, x.r_.first, alloc}, capacity_{x.capacity_}, size_{x.size_}
+			: r_{internal::ZeroThen{}, alloc}
 		{
-			x.r_.first = nullptr;
-			x.capacity_ = 0;
-			x.size_ = 0;
+			steal(x);
 		}
 
 		vector(std::initializer_list<T> init, const Alloc& alloc = Alloc{})
@@ -100,9 +169,7 @@ namespace ostl
 			const size_type s = init.size();
 			reserve(s);
 			size_ = s;
-			pointer p = r_.first;
-			for (auto it = init.begin(); it != init.end(); ++it)
-				std::allocator_traits<Alloc>::construct(r_.second, p++, *it);
+			copy(r_.first, init.begin(), s);
 		}
 
 		~vector() noexcept
@@ -113,13 +180,17 @@ namespace ostl
 
 		vector& operator=(const vector& x)
 		{
+			if (this == &x) return *this;
 			clear();
-			r_.second = x.r_.second;
+			if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value)
+			{
+				// The buffer must go back to the allocator that made it
+				if (r_.second != x.r_.second) shrink_to_fit();
+				r_.second = x.r_.second;
+			}
 			reserve(x.size_);
 			size_ = x.size_;
-			pointer p = r_.first;
-			for (const value_type& a : x)
-				std::allocator_traits<Alloc>::construct(r_.second, p++, a);
+			copy(r_.first, x.r_.first, size_);
 			return *this;
 		}
 
@@ -127,15 +198,25 @@ namespace ostl
 		noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
 			|| std::allocator_traits<Alloc>::is_always_equal::value)
 		{
+			if (this == &x) return *this;
 			clear();
+			if constexpr (!std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value
+				&& !std::allocator_traits<Alloc>::is_always_equal::value)
+			{
+				// Keeps its own allocator and buffer and moves the elements over
+				if (r_.second != x.r_.second)
+				{
+					reserve(x.size_);
+					move(x.r_.first, r_.first, x.size_);
+					size_ = x.size_;
+					x.size_ = 0;
+					return *this;
+				}
+			}
 			shrink_to_fit();
-			r_.second = x.r_.second;
-			r_.first = x.r_.first;
-			capacity_ = x.capacity_;
-			size_ = x.size_;
-			x.r_.first = nullptr;
-			x.capacity_ = 0;
-			x.size_ = 0;
+			if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value)
+				r_.second = x.r_.second;
+			steal(x);
 			return *this;
 		}
 
@@ -145,9 +226,7 @@ namespace ostl
 			const size_type s = init.size();
 			inc_cap(s);
 			size_ = s;
-			pointer p = r_.first;
-			for (auto it = init.begin(); it != init.end(); ++it)
-				std::allocator_traits<Alloc>::construct(r_.second, p++, *it);
+			copy(r_.first, init.begin(), s);
 			return *this;
 		}
 
@@ -156,8 +235,7 @@ namespace ostl
 			clear();
 			inc_cap(n);
 			size_ = n;
-			for (size_type i = 0; i < n; ++i)
-				std::allocator_traits<Alloc>::construct(r_.second, r_.first + i, t);
+			fill(r_.first, n, t);
 		}
 
 		template <class InputIt, class = std::enable_if_t<
@@ -168,9 +246,14 @@ namespace ostl
 		void assign(const InputIt first, const InputIt last)
 		{
 			clear();
-			inc_cap(std::distance(first, last));
-			for (InputIt it = first; it != last; ++it)
-				emplace_back(*it);
+			insert(cend(), first, last);
+		}
+
+		template <class R>
+		void assign_range(R&& rg)
+		{
+			clear();
+			append_range(std::forward<R>(rg));
 		}
 
 		void assign(std::initializer_list<T> init)
@@ -179,9 +262,7 @@ namespace ostl
 			const size_type s = init.size();
 			inc_cap(s);
 			size_ = s;
-			pointer p = r_.first;
-			for (auto it = init.begin(); it != init.end(); ++it)
-				std::allocator_traits<Alloc>::construct(r_.second, p++, *it);
+			copy(r_.first, init.begin(), s);
 		}
 
 		[[nodiscard]] allocator_type get_allocator() const noexcept { return r_.second; }
@@ -209,7 +290,14 @@ namespace ostl
 		[[nodiscard]] const_reference back() const { return r_.first[size_ - 1]; }
 
 		[[nodiscard]] pointer data() noexcept { return const_cast<pointer>(static_cast<const vector&>(*this).data()); }
-		[[nodiscard]] const_pointer data() const noexcept { return r_.first; }
+		[[nodiscard]] const_pointer data() const noexcept
+		{
+			// Lets the compiler use aligned loads when the allocator promises more than alignof(T)
+			if constexpr (N == 0 && std::is_pointer_v<pointer> && internal::AllocAlignment<Alloc> > alignof(T))
+				return std::assume_aligned<internal::AllocAlignment<Alloc>>(r_.first);
+			else
+				return r_.first;
+		}
 
 		[[nodiscard]] iterator begin() noexcept { return iterator{r_.first}; }
 		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator{r_.first}; }
@@ -235,44 +323,24 @@ namespace ostl
 		{
 			if (n > max_size()) throw std::length_error{""};
 			if (n <= capacity_) return;
-
-			const pointer p = r_.second.allocate(n);
-			if (r_.first)
-			{
-				for (size_type i = 0; i < size_; ++i)
-				{
-					std::allocator_traits<Alloc>::construct(r_.second, p + i, std::move(r_.first[i]));
-					std::allocator_traits<Alloc>::destroy(r_.second, r_.first + i);
-				}
-				r_.second.deallocate(r_.first, capacity_);
-			}
-			r_.first = p;
-			capacity_ = n;
+			reallocate(n);
 		}
 
 		[[nodiscard]] size_type capacity() const noexcept { return capacity_; }
 
 		void shrink_to_fit()
 		{
-			if (size_ == capacity_) return;
+			if (size_ == capacity_ || is_inline()) return;
 
 			if (size_ == 0)
 			{
-				r_.second.deallocate(r_.first, capacity_);
+				deallocate();
 				r_.first = nullptr;
 				capacity_ = 0;
 			}
 			else
 			{
-				const pointer n = r_.second.allocate(size_);
-				for (size_type i = 0; i < size_; ++i)
-				{
-					std::allocator_traits<Alloc>::construct(r_.second, n + i, std::move(r_.first[i]));
-					std::allocator_traits<Alloc>::destroy(r_.second, r_.first + i);
-				}
-				r_.second.deallocate(r_.first, capacity_);
-				r_.first = n;
-				capacity_ = size_;
+				reallocate(size_);
 			}
 		}
 
@@ -289,8 +357,7 @@ namespace ostl
 		iterator insert(const_iterator position, size_type n, const T& x)
 		{
 			const pointer it = shift(position - cbegin(), n);
-			for (size_type i = 0; i < n; ++i)
-				std::allocator_traits<Alloc>::construct(r_.second, it + i, x);
+			fill(it, n, x);
 			size_ += n;
 			return iterator{it};
 		}
@@ -302,17 +369,40 @@ namespace ostl
 			                            iterator_category>>>
 		iterator insert(const_iterator position, InputIt first, InputIt last)
 		{
-			const difference_type offset = position-- - cbegin();
-			while (first != last) position = emplace(++position, *first++);
-			return begin() + offset;
+			if constexpr (internal::IsForwardIterator<InputIt>)
+			{
+				return insert_n(position - cbegin(), first, std::distance(first, last));
+			}
+			else
+			{
+				const difference_type offset = position-- - cbegin();
+				while (first != last) position = emplace(++position, *first++);
+				return begin() + offset;
+			}
+		}
+
+		template <class R>
+		iterator insert_range(const_iterator position, R&& rg)
+		{
+			if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>)
+			{
+				return insert_n(position - cbegin(), std::ranges::begin(rg), std::ranges::distance(rg));
+			}
+			else
+			{
+				const difference_type offset = position-- - cbegin();
+				for (auto&& x : rg) position = emplace(++position, std::forward<decltype(x)>(x));
+				return begin() + offset;
+			}
 		}
 
+		template <class R>
+		void append_range(R&& rg) { insert_range(cend(), std::forward<R>(rg)); }
+
 		iterator insert(const_iterator position, std::initializer_list<T> list)
 		{
 			const pointer first = shift(position - cbegin(), list.size());
-			pointer it = first;
-			for (const T& x : list)
-				std::allocator_traits<Alloc>::construct(r_.second, it++, x);
+			copy(first, list.begin(), list.size());
 			size_ += list.size();
 			return iterator{first};
 		}
@@ -353,7 +443,22 @@ namespace ostl
 		void push_back(T&& x) { emplace_back(std::move(x)); }
 
 		template <class... Args>
-		void emplace_back(Args&& ... args) { emplace(cend(), std::forward<Args>(args)...); }
+		void emplace_back(Args&& ... args)
+		{
+			if (size_ == capacity_) grow_emplace_back(std::forward<Args>(args)...);
+			else emplace_back_unchecked(std::forward<Args>(args)...);
+		}
+
+		void push_back_unchecked(const T& x) { emplace_back_unchecked(x); }
+		void push_back_unchecked(T&& x) { emplace_back_unchecked(std::move(x)); }
+
+		// Caller guarantees size() < capacity()
+		template <class... Args>
+		void emplace_back_unchecked(Args&& ... args)
+		{
+			std::allocator_traits<Alloc>::construct(r_.second, r_.first + size_, std::forward<Args>(args)...);
+			++size_;
+		}
 
 		void pop_back() { erase(cend() - 1); }
 
@@ -362,7 +467,7 @@ namespace ostl
 			if (size_ < sz)
 			{
 				inc_cap(sz);
-				pointer it = r_.first + sz;
+				pointer it = r_.first + size_;
 				for (size_type i = sz - size_; i; --i)
 					std::allocator_traits<Alloc>::construct(r_.second, it++);
 				size_ = sz;
@@ -371,6 +476,34 @@ namespace ostl
 				erase(cbegin() + sz, cend());
 		}
 
+		// Like resize(sz), but new elements are default-initialized: trivial types are left as garbage
+		void resize_for_overwrite(size_type sz)
+		{
+			if (size_ < sz)
+				append_uninitialized(sz - size_);
+			else if (size_ > sz)
+				erase(cbegin() + sz, cend());
+		}
+
+		// Appends n default-initialized elements and returns a pointer to the first of them
+		pointer append_uninitialized(const size_type n)
+		{
+			inc_cap(size_ + n);
+			const pointer p = r_.first + size_;
+			if constexpr (!internal::IsPlainConstruct<Alloc, T>::value)
+			{
+				for (size_type i = 0; i < n; ++i)
+					std::allocator_traits<Alloc>::construct(r_.second, p + i);
+			}
+			else if constexpr (!std::is_trivially_default_constructible_v<T>)
+			{
+				for (size_type i = 0; i < n; ++i)
+					::new (static_cast<void*>(std::to_address(p + i))) T;
+			}
+			size_ += n;
+			return p;
+		}
+
 		void resize(size_type sz, const T& c)
 		{
 			if (size_ < sz)
@@ -397,93 +530,235 @@ namespace ostl
 		{
 			if (capacity_ == 0)
 			{
-				capacity_ = new_cap(count);
-				r_.first = r_.second.allocate(capacity_);
+				allocate(new_cap(count));
 				return r_.first;
 			}
 
 			const size_type minReqCap = size_ + count;
-			const size_type recommendedCap = new_cap(minReqCap);
-			const pointer newMem = capacity_ < minReqCap ? r_.second.allocate(recommendedCap) : nullptr;
+
+			if constexpr (in_place_growth)
+			{
+				if (capacity_ < minReqCap) reallocate(new_cap(minReqCap));
+				move(r_.first + position, r_.first + position + count, size_ - position);
+				return r_.first + position;
+			}
+
+			const auto [newMem, newCap] = capacity_ < minReqCap
+				? allocate_at_least(new_cap(minReqCap))
+				: internal::AllocationResult<pointer>{nullptr, 0};
 
 			move(r_.first + position, (newMem ? newMem : r_.first) + position + count, size_ - position);
 
 			if (newMem)
 			{
 				move(r_.first, newMem, position);
-				r_.second.deallocate(r_.first, capacity_);
+				deallocate();
 				r_.first = newMem;
-				capacity_ = recommendedCap;
+				capacity_ = newCap;
 			}
 
 			return r_.first + position;
 		}
 
+		static constexpr bool relocatable = internal::CanRelocate<T, Alloc>;
+		// realloc only on request (growth::in_place), allocator-provided reallocate (e.g. mremap) always
+		static constexpr bool in_place_growth = relocatable && N == 0
+			&& (internal::TriesInPlace<Growth>::value && internal::UsesMalloc<Alloc>::value
+				|| internal::HasReallocate<Alloc>::value);
+
+		// Constructs the new element before relocating so that args may alias existing elements
+		template <class... Args>
+		OSTL_NOINLINE void grow_emplace_back(Args&& ... args)
+		{
+			if constexpr (in_place_growth)
+			{
+				T x(std::forward<Args>(args)...);
+				reallocate(new_cap(size_ + 1));
+				std::allocator_traits<Alloc>::construct(r_.second, r_.first + size_, std::move(x));
+				++size_;
+				return;
+			}
+
+			const auto [newMem, newCap] = allocate_at_least(new_cap(size_ + 1));
+			std::allocator_traits<Alloc>::construct(r_.second, newMem + size_, std::forward<Args>(args)...);
+			move(r_.first, newMem, size_);
+			deallocate();
+			r_.first = newMem;
+			capacity_ = newCap;
+			++size_;
+		}
+
 		void move(pointer src, pointer dest, size_type count)
 		{
 			if (src == dest || count == 0) return;
-			static constexpr auto inc = [](pointer& p) { ++p; };
-			static constexpr auto dec = [](pointer& p) { --p; };
-			void (*op)(pointer&) = inc;
-			if (src < dest)
+
+			if constexpr (relocatable)
+			{
+				std::memmove(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+			}
+			else if (src < dest)
 			{
-				op = dec;
-				src += count - 1;
-				dest += count - 1;
+				for (size_type i = count; i--;)
+					relocate(src + i, dest + i);
 			}
-			while (count--)
+			else
 			{
-				std::allocator_traits<Alloc>::construct(r_.second, dest, std::move(*src));
-				std::allocator_traits<Alloc>::destroy(r_.second, src);
-				op(src);
-				op(dest);
+				for (size_type i = 0; i < count; ++i)
+					relocate(src + i, dest + i);
+			}
+		}
+
+		void relocate(pointer src, pointer dest)
+		{
+			std::allocator_traits<Alloc>::construct(r_.second, dest, std::move(*src));
+			std::allocator_traits<Alloc>::destroy(r_.second, src);
+		}
+
+		static constexpr bool bulk_copyable = internal::CanBulkCopy<T, Alloc>;
+
+		template <class It>
+		static constexpr bool contiguous = std::is_same_v<It, iterator> || std::is_same_v<It, const_iterator>
+			|| std::is_pointer_v<It> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, T>;
+
+		template <class It>
+		void copy(pointer dest, It src, size_type count)
+		{
+			if constexpr (bulk_copyable && contiguous<It>)
+			{
+				if (count) std::memcpy(static_cast<void*>(dest), static_cast<const void*>(std::addressof(*src)), count * sizeof(T));
+			}
+			else
+			{
+				for (size_type i = 0; i < count; ++i, ++src)
+					std::allocator_traits<Alloc>::construct(r_.second, dest + i, *src);
+			}
+		}
+
+		template <class It>
+		iterator insert_n(const size_type position, It first, const size_type count)
+		{
+			if (count == 0) return begin() + position;
+			const pointer it = shift(position, count);
+			copy(it, first, count);
+			size_ += count;
+			return iterator{it};
+		}
+
+		void fill(pointer dest, size_type count, const T& value)
+		{
+			if constexpr (bulk_copyable)
+			{
+				std::uninitialized_fill_n(dest, count, value);
+			}
+			else
+			{
+				for (size_type i = 0; i < count; ++i)
+					std::allocator_traits<Alloc>::construct(r_.second, dest + i, value);
 			}
 		}
 
 		void inc_cap(const size_type minReqCap)
 		{
 			if (capacity_ < minReqCap)
+				reallocate(new_cap(minReqCap));
+		}
+
+		[[nodiscard]] pointer inline_data() const noexcept
+		{
+			if constexpr (N == 0) return nullptr;
+			else return reinterpret_cast<pointer>(const_cast<unsigned char*>(this->buffer));
+		}
+
+		[[nodiscard]] bool is_inline() const noexcept { return N != 0 && r_.first == inline_data(); }
+
+		[[nodiscard]] internal::AllocationResult<pointer> allocate_at_least(const size_type n)
+		{
+			if (n <= N && !is_inline()) return {inline_data(), N};
+			return internal::AllocateAtLeast(r_.second, n);
+		}
+
+		void allocate(const size_type n)
+		{
+			const auto [p, cap] = allocate_at_least(n);
+			r_.first = p;
+			capacity_ = cap;
+		}
+
+		void reallocate(const size_type n)
+		{
+			if constexpr (in_place_growth)
 			{
-				const size_type newCap = new_cap(minReqCap);
-				const pointer newMem = r_.second.allocate(newCap);
-				move(r_.first, newMem, size_);
-				r_.second.deallocate(r_.first, capacity_);
-				r_.first = newMem;
-				capacity_ = newCap;
+				const auto [p, cap] = internal::Reallocate(r_.second, r_.first, capacity_, n);
+				r_.first = p;
+				capacity_ = cap;
+			}
+			else
+			{
+				const auto [p, cap] = allocate_at_least(n);
+				move(r_.first, p, size_);
+				deallocate();
+				r_.first = p;
+				capacity_ = cap;
+			}
+		}
+
+		void deallocate() noexcept
+		{
+			if (r_.first && !is_inline()) internal::Deallocate(r_.second, r_.first, capacity_);
+		}
+
+		// Takes x's contents; *this must hold no heap block. Inline elements are relocated one by one.
+		void steal(vector& x)
+		{
+			if (x.is_inline())
+			{
+				if (!is_inline()) allocate(N);
+				move(x.r_.first, r_.first, x.size_);
+				size_ = x.size_;
+				x.size_ = 0;
+			}
+			else
+			{
+				r_.first = x.r_.first;
+				capacity_ = x.capacity_;
+				size_ = x.size_;
+				x.r_.first = nullptr;
+				x.capacity_ = 0;
+				x.size_ = 0;
 			}
 		}
 
 		[[nodiscard]] size_type new_cap(const size_type required) const
 		{
-			size_type new_cap = std::max<size_type>(1, capacity_);
-			while (new_cap < required)
-				new_cap = std::max<size_type>(2, new_cap * 3 / 2);
-			return new_cap;
+			return Growth::next_capacity(capacity_, required, sizeof(T));
 		}
 	};
 
-	template <class T, class Alloc>
-	[[nodiscard]] typename vector<T, Alloc>::const_iterator operator+
-	(typename vector<T, Alloc>::difference_type n, typename vector<T, Alloc>::const_iterator it)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] typename vector<T, Alloc, Growth, N>::const_iterator operator+
+	(typename vector<T, Alloc, Growth, N>::difference_type n, typename vector<T, Alloc, Growth, N>::const_iterator it)
 	{
 		return it + n;
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] typename vector<T, Alloc>::iterator operator+
-	(typename vector<T, Alloc>::difference_type n, typename vector<T, Alloc>::iterator it)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] typename vector<T, Alloc, Growth, N>::iterator operator+
+	(typename vector<T, Alloc, Growth, N>::difference_type n, typename vector<T, Alloc, Growth, N>::iterator it)
 	{
 		return it + n;
 	}
 
 	namespace pmr
 	{
-		template <class T>
-		using vector = ostl::vector<T, std::pmr::polymorphic_allocator<T>>;
+		template <class T, class Growth = growth::geometric<>>
+		using vector = ostl::vector<T, std::pmr::polymorphic_allocator<T>, Growth>;
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] bool operator==(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, size_t N, class Alloc = std::allocator<T>, class Growth = growth::geometric<>>
+	using small_vector = vector<T, Alloc, Growth, N>;
+
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] bool operator==(const vector<T, Alloc, Growth, N>& lhs, const vector<T, Alloc, Growth, N>& rhs)
 	{
 		if (lhs.size() != rhs.size()) return false;
 		const auto end = lhs.end();
@@ -492,47 +767,47 @@ namespace ostl
 		return true;
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] bool operator!=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] bool operator!=(const vector<T, Alloc, Growth, N>& lhs, const vector<T, Alloc, Growth, N>& rhs)
 	{
 		return !(lhs == rhs);
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] bool operator<(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] bool operator<(const vector<T, Alloc, Growth, N>& lhs, const vector<T, Alloc, Growth, N>& rhs)
 	{
 		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] bool operator<=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] bool operator<=(const vector<T, Alloc, Growth, N>& lhs, const vector<T, Alloc, Growth, N>& rhs)
 	{
 		return lhs < rhs || lhs == rhs;
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] bool operator>(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] bool operator>(const vector<T, Alloc, Growth, N>& lhs, const vector<T, Alloc, Growth, N>& rhs)
 	{
 		return !(lhs <= rhs);
 	}
 
-	template <class T, class Alloc>
-	[[nodiscard]] bool operator>=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth, size_t N>
+	[[nodiscard]] bool operator>=(const vector<T, Alloc, Growth, N>& lhs, const vector<T, Alloc, Growth, N>& rhs)
 	{
 		return !(lhs < rhs);
 	}
 
-	template <class T, class Alloc>
-	void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) { lhs.swap(rhs); }
+	template <class T, class Alloc, class Growth, size_t N>
+	void swap(vector<T, Alloc, Growth, N>& lhs, vector<T, Alloc, Growth, N>& rhs) noexcept(noexcept(lhs.swap(rhs))) { lhs.swap(rhs); }
 
-	template <class T, class Alloc, class U>
-	void erase(vector<T, Alloc>& c, const U& value)
+	template <class T, class Alloc, class Growth, size_t N, class U>
+	void erase(vector<T, Alloc, Growth, N>& c, const U& value)
 	{
 		c.erase(std::remove(c.begin(), c.end(), value), c.end());
 	}
 
-	template <class T, class Alloc, class Pred>
-	void erase(vector<T, Alloc>& c, Pred pred)
+	template <class T, class Alloc, class Growth, size_t N, class Pred>
+	void erase(vector<T, Alloc, Growth, N>& c, Pred pred)
 	{
 		c.erase(std::remove_if(c.begin(), c.end(), pred), c.end());
 	}
@@ -541,8 +816,8 @@ namespace ostl
 	template <class InputIt, class Alloc = std::allocator<typename std::iterator_traits<InputIt>::value_type>>
 	vector(InputIt, InputIt, Alloc = Alloc{}) -> vector<typename std::iterator_traits<InputIt>::value_type, Alloc>;
 
-	template <class Alloc>
-	class vector<bool, Alloc>
+	template <class Alloc, class Growth, size_t N>
+	class vector<bool, Alloc, Growth, N>
 	{
 	public:
 		using value_type = bool;
@@ -551,6 +826,8 @@ namespace ostl
 		using difference_type = ptrdiff_t;
 		using const_reference = bool;
 
+		static constexpr auto npos = size_type(-1);
+
 	private:
 		using int_type = size_t;
 		using num_bit_type = unsigned char;
@@ -678,6 +955,8 @@ namespace ostl
 			[[nodiscard]] bool operator<=(const const_iterator& rhs) const { return !(*this > rhs); }
 
 		protected:
+			friend vector;
+
 			int_type* ptr_ = nullptr;
 			num_bit_type bit_offset_ = 0;
 		};
@@ -789,9 +1068,16 @@ namespace ostl
 			          || std::is_same_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
 			                            iterator_category>>>
 		vector(InputIt first, InputIt last, const Alloc& alloc = Alloc{})
-			: size_{static_cast<size_type>(std::distance(first, last))}
+			: vec_{alloc}, size_{static_cast<size_type>(std::distance(first, last))}
 		{
 			const auto s = (size_ + (n_bit - 1)) / n_bit;
+			if constexpr (is_bit_iterator<InputIt>)
+			{
+				vec_.resize_for_overwrite(s);
+				internal::CopyBits(vec_.data(), 0, first.ptr_, first.bit_offset_, size_);
+				return;
+			}
+
 			vec_.reserve(s);
 			for (size_type i = 0; i < s; ++i)
 			{
@@ -816,6 +1102,14 @@ namespace ostl
 		{
 		}
 
+		// Evaluates a bit expression such as a & b & ~c in one pass
+		template <class E, class = std::enable_if_t<internal::IsBitExpr<E>>>
+		vector(const E& e, const Alloc& alloc = Alloc{}) : vec_{alloc}, size_{e.size()}
+		{
+			vec_.resize_for_overwrite((size_ + (n_bit - 1)) / n_bit);
+			internal::EvalBits(vec_.data(), vec_.size(), e, internal::BitAssign{});
+		}
+
 		~vector() = default;
 
 		vector& operator=(const vector&) = default;
@@ -832,7 +1126,28 @@ namespace ostl
 
 		vector& operator=(std::initializer_list<bool> init) { return *this = vector(init, vec_.get_allocator()); }
 
-		void assign(const size_type n, bool int_type) { *this = vector(n, int_type, vec_.get_allocator()); }
+		template <class E, class = std::enable_if_t<internal::IsBitExpr<E>>>
+		vector& operator=(const E& e) { return *this = vector(e, vec_.get_allocator()); }
+
+		template <class E, class = std::enable_if_t<internal::IsBitOperand<E>>>
+		vector& operator&=(const E& x) { return apply(internal::ToBitExpr(x), internal::BitAnd{}); }
+
+		template <class E, class = std::enable_if_t<internal::IsBitOperand<E>>>
+		vector& operator|=(const E& x) { return apply(internal::ToBitExpr(x), internal::BitOr{}); }
+
+		template <class E, class = std::enable_if_t<internal::IsBitOperand<E>>>
+		vector& operator^=(const E& x) { return apply(internal::ToBitExpr(x), internal::BitXor{}); }
+
+		// *this &= ~x
+		template <class E, class = std::enable_if_t<internal::IsBitOperand<E>>>
+		vector& and_not(const E& x) { return apply(internal::ToBitExpr(x), internal::BitAndNot{}); }
+
+		void assign(const size_type n, const bool value)
+		{
+			vec_.resize_for_overwrite((n + (n_bit - 1)) / n_bit);
+			size_ = n;
+			internal::FillBits(vec_.data(), 0, n, value);
+		}
 
 		template <class InputIt, class = std::enable_if_t<
 			          std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<InputIt>::
@@ -901,14 +1216,12 @@ namespace ostl
 
 		iterator insert(const_iterator position, size_type n, bool x)
 		{
-			const difference_type d = position - begin();
-			move(position, position + n, size_ - d);
+			const size_type d = position - cbegin();
+			move(d, d + n, size_ - d);
 			
 			size_ += n;
-			
-			const auto ret = begin() + d;
-			for (auto it = ret; n--;) *it++ = x;
-			return ret;
+			internal::FillBits(vec_.data(), d, n, x);
+			return begin() + d;
 		}
 
 		template <class InputIt, class = std::enable_if_t<
@@ -918,11 +1231,28 @@ namespace ostl
 			                            iterator_category>>>
 		iterator insert(const_iterator position, InputIt first, InputIt last)
 		{
-			const difference_type d = position - begin();
+			if constexpr (is_bit_iterator<InputIt>)
+			{
+				// Growing could free the source words, so a range of our own bits goes through a copy
+				const std::less<const int_type*> less;
+				if (!less(first.ptr_, vec_.data()) && less(first.ptr_, vec_.data() + vec_.size()))
+				{
+					const vector copy(first, last, vec_.get_allocator());
+					return insert(position, copy.cbegin(), copy.cend());
+				}
+			}
+
+			const size_type d = position - cbegin();
 			difference_type n = std::distance(first, last);
-			move(position, position + n, size_ - d);
+			move(d, d + n, size_ - d);
 			
 			size_ += n;
+
+			if constexpr (is_bit_iterator<InputIt>)
+			{
+				internal::CopyBits(vec_.data(), d, first.ptr_, first.bit_offset_, n);
+				return begin() + d;
+			}
 			
 			const auto ret = begin() + d;
 			for (auto it = ret; n--;) *it++ = *first++;
@@ -947,9 +1277,10 @@ namespace ostl
 
 		iterator erase(const_iterator first, const_iterator last)
 		{
-			move(last, first, size_ - (last - begin()));
-			size_ -= last - first;
-			return begin() + (first - begin());
+			const size_type f = first - cbegin(), l = last - cbegin();
+			move(l, f, size_ - l);
+			size_ -= l - f;
+			return begin() + f;
 		}
 
 		void push_back(bool x) { insert(cend(), x); }
@@ -964,9 +1295,7 @@ namespace ostl
 			if (size_ < sz)
 			{
 				inc_cap(sz);
-				iterator it = begin() + sz;
-				for (size_type i = sz - size_; i; --i)
-					*it++ = false;
+				internal::FillBits(vec_.data(), size_, sz - size_, false);
 				size_ = sz;
 			}
 			else if (size_ > sz)
@@ -990,33 +1319,100 @@ namespace ostl
 			*this = std::move(int_type);
 		}
 
+		void flip() noexcept
+		{
+			int_type* w = vec_.data();
+			for (size_type i = 0, n = (size_ + (n_bit - 1)) / n_bit; i < n; ++i) w[i] = ~w[i];
+		}
+
+		// Backing words, least significant bit first. Bits of the last word past size() are unspecified.
+		[[nodiscard]] const int_type* words() const noexcept { return vec_.data(); }
+		[[nodiscard]] int_type* words() noexcept { return vec_.data(); }
+
+		[[nodiscard]] size_type count() const noexcept
+		{
+			const int_type* w = vec_.data();
+			const size_type whole = size_ / n_bit, rest = size_ % n_bit;
+			size_type c = internal::PopCount(w, whole);
+			if (rest) c += std::popcount(w[whole] & internal::LowMask(rest));
+			return c;
+		}
+
+		[[nodiscard]] bool any() const noexcept { return find_first() != npos; }
+		[[nodiscard]] bool none() const noexcept { return !any(); }
+		[[nodiscard]] bool all() const noexcept { return find_first_unset() == npos; }
+
+		// Index of the first set bit, or npos
+		[[nodiscard]] size_type find_first() const noexcept { return find_from(0, 0); }
+
+		// Index of the first set bit after pos, or npos; pos may be npos
+		[[nodiscard]] size_type find_next(const size_type pos) const noexcept
+		{
+			return pos >= size_ ? npos : find_from(pos + 1, 0);
+		}
+
+		[[nodiscard]] size_type find_first_unset() const noexcept { return find_from(0, ~int_type{0}); }
+
+		[[nodiscard]] size_type find_next_unset(const size_type pos) const noexcept
+		{
+			return pos >= size_ ? npos : find_from(pos + 1, ~int_type{0});
+		}
+
 	private:
-		void move(const_iterator src, const_iterator dest, size_type cnt)
+		template <class It>
+		static constexpr bool is_bit_iterator = std::is_same_v<It, iterator> || std::is_same_v<It, const_iterator>;
+
+		// Operands longer than *this are zero-extended into a fresh vector, since growing in place could
+		// reallocate words that e still points to
+		template <class E, class Op>
+		vector& apply(const E& e, const Op op)
 		{
-			const difference_type d = dest - src;
-			if (d > 0) inc_cap(size_ + d);
-				
-			if (d == 0 || cnt == 0) return;
-			
-			if (d > 0)
-			{
-				for (size_type i = src - begin() + cnt - 1; cnt--; --i)
-					(*this)[i + d] = (*this)[i];
-			}
-			else
+			if (e.size() > size_)
+				return *this = vector(internal::BitBinary<Op, internal::BitLeaf, E>{internal::ToBitExpr(*this), e}, vec_.get_allocator());
+
+			internal::EvalBits(vec_.data(), (size_ + (n_bit - 1)) / n_bit, e, op);
+			return *this;
+		}
+
+		[[nodiscard]] size_type find_from(const size_type pos, const int_type flip) const noexcept
+		{
+			if (pos >= size_) return npos;
+
+			const int_type* w = vec_.data();
+			const size_type words = (size_ + (n_bit - 1)) / n_bit;
+			size_type i = pos / n_bit;
+			int_type bits = (w[i] ^ flip) & ~int_type{0} << pos % n_bit;
+			if (!bits)
 			{
-				for (size_type i = src - begin(); cnt--; ++i)
-					(*this)[i + d] = (*this)[i];
+				i = internal::FindWord(w, i + 1, words, flip);
+				if (i == words) return npos;
+				bits = w[i] ^ flip;
 			}
+
+			const size_type found = i * n_bit + std::countr_zero(bits);
+			return found < size_ ? found : npos;
+		}
+
+		void move(size_type src, size_type dest, size_type cnt)
+		{
+			if (dest > src) inc_cap(size_ + (dest - src));
+			internal::CopyBits(vec_.data(), dest, vec_.data(), src, cnt);
 		}
 
 		void inc_cap(size_type min)
 		{
 			if (min > vec_.size() * n_bit)
-				vec_.insert(vec_.end(), (min - vec_.size() * n_bit + n_bit - 1) / n_bit, 0);
+				vec_.resize_for_overwrite((min + (n_bit - 1)) / n_bit);
 		}
 
-		vector<int_type, typename std::allocator_traits<Alloc>::template rebind_alloc<int_type>> vec_;
+		vector<int_type, typename std::allocator_traits<Alloc>::template rebind_alloc<int_type>, Growth,
+		       (N + (n_bit - 1)) / n_bit> vec_;
 		size_type size_ = 0;
 	};
+
+	namespace internal
+	{
+		template <class Alloc, class Growth, size_t N>
+		inline constexpr bool IsBoolVector<vector<bool, Alloc, Growth, N>> = true;
+	}
 }